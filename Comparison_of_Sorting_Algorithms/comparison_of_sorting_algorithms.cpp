@@ -11,27 +11,583 @@
 #include <ctime>
 #include <climits>
 #include <iomanip>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <iterator>
+#include <utility>
+#include <cstdint>
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_SORT_AVAILABLE
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 #ifdef _WIN32
-#include <Windows.h>
 #include <conio.h>
 #elif __linux__
 #include <ncurses.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #endif
 
-/* Macro definition */
+/* Macro definitions */
 #define MEMORY_ALLOCATION_ERROR -1
+#define INVALID_ARGUMENT_ERROR -2
+#define FILE_OPEN_ERROR -3
+#define FILE_IO_ERROR -4
+#define HW_COUNTER_NUM 7
+#define MAX_BATCH_ITEMS 64
+#define INTRO_SORT_THRESHOLD 16
+#define NINTHER_THRESHOLD 128
+#define FLOYD_RIVEST_THRESHOLD 600
+#define SELECT_OPTION_NUM 3
+#define VERIFY_SEED_A 0x9e3779b9u
+#define VERIFY_SEED_B 0x7f4a7c15u
+#define SHELL_MAX_GAPS 512
+#define CACHE_LINE_BYTES 64
+#define MERGE_RUN_LENGTH 32
+#define MERGE_BLOCK_BYTES (16 << 10)
+#define TIM_SORT_MIN_MERGE 64
+#define TIM_SORT_MIN_GALLOP 7
+#define TIM_SORT_MAX_RUNS 64
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define SIMD_BLOCK_SIZE 64
+#define GENERIC_SORT_OPTION_NUM 4
+#define FIXED_STRING_LENGTH 16
+#define EXTERNAL_MIN_BUFFER (1LL << 20)
+#ifdef __GNUC__
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#if defined(_MSC_VER) && defined(SIMD_SORT_AVAILABLE)
+#define PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#elif defined(__GNUC__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address)
+#endif
+
+/* Define SortStats structure */
+struct SortStats {
+    unsigned long long comparisons;
+    unsigned long long moves;
+    unsigned long long allocatedBytes;
+    int depth;
+    int maxDepth;
+};
+
+/* Define NullInstrument structure, every call compiles to nothing in the timed instantiation */
+struct NullInstrument {
+    static const bool enabled = false;
+    bool compare(bool result) { return result; }
+    void compared(unsigned long long) {}
+    void moved(unsigned long long) {}
+    void allocated(unsigned long long) {}
+    void enter(void) {}
+    void leave(void) {}
+    NullInstrument fork(void) const { return NullInstrument(); }
+    void merge(const NullInstrument&) {}
+};
+
+/* Define CountingInstrument structure, the statistics of one sort run */
+struct CountingInstrument {
+    static const bool enabled = true;
+    SortStats stats;
+    CountingInstrument() :stats() {}
+    bool compare(bool result) { stats.comparisons++; return result; }
+    void compared(unsigned long long count) { stats.comparisons += count; }
+    void moved(unsigned long long count) { stats.moves += count; }
+    void allocated(unsigned long long bytes) { stats.allocatedBytes += bytes; }
+    void enter(void) { stats.maxDepth = std::max(stats.maxDepth, ++stats.depth); }
+    void leave(void) { stats.depth--; }
+    CountingInstrument fork(void) const;
+    void merge(const CountingInstrument& other);
+};
+
+/*
+ * Function Name:    fork
+ * Function:         Create the instrument of a parallel task spawned at the current depth
+ * Input Parameters: void
+ * Return Value:     the task instrument
+ * Notes:            Class external implementation of member functions
+ */
+CountingInstrument CountingInstrument::fork(void) const
+{
+    CountingInstrument child;
+    child.stats.depth = child.stats.maxDepth = stats.depth;
+    return child;
+}
+
+/*
+ * Function Name:    merge
+ * Function:         Add the statistics of a finished task
+ * Input Parameters: const CountingInstrument& other
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void CountingInstrument::merge(const CountingInstrument& other)
+{
+    stats.comparisons += other.stats.comparisons;
+    stats.moves += other.stats.moves;
+    stats.allocatedBytes += other.stats.allocatedBytes;
+    stats.maxDepth = std::max(stats.maxDepth, other.stats.maxDepth);
+}
+
+/* Define DepthGuard structure template */
+template <typename Instrument>
+struct DepthGuard {
+    Instrument& ins;
+    DepthGuard(Instrument& _ins) :ins(_ins) { ins.enter(); }
+    ~DepthGuard() { ins.leave(); }
+};
+
+/* Define TypedSortOption structure template */
+template <typename Type>
+struct TypedSortOption {
+    void (*func)(Type*, int, NullInstrument&);
+    void (*countedFunc)(Type*, int, CountingInstrument&);
+    const char* name;
+    const char* description;
+    bool stable;
+    void (*keyValueFunc)(Type*, unsigned int*, int, NullInstrument&);
+    void (*countedKeyValueFunc)(Type*, unsigned int*, int, CountingInstrument&);
+    TypedSortOption(void (*_func)(Type*, int, NullInstrument&), void (*_countedFunc)(Type*, int, CountingInstrument&),
+                    const char* _name, const char* _description, bool _stable,
+                    void (*_keyValueFunc)(Type*, unsigned int*, int, NullInstrument&) = NULL,
+                    void (*_countedKeyValueFunc)(Type*, unsigned int*, int, CountingInstrument&) = NULL)
+        :func(_func), countedFunc(_countedFunc), name(_name), description(_description), stable(_stable),
+        keyValueFunc(_keyValueFunc), countedKeyValueFunc(_countedKeyValueFunc) {}
+};
+
+/* Define TypedSelectOption structure template, the functions move the k-th smallest element to arr[k] */
+template <typename Type>
+struct TypedSelectOption {
+    void (*func)(Type*, int, int, NullInstrument&);
+    void (*countedFunc)(Type*, int, int, CountingInstrument&);
+    const char* name;
+    const char* description;
+};
+
+/* Define SortFunction types */
+typedef void (*SortFunction)(int*, int, NullInstrument&);
+typedef void (*CountedSortFunction)(int*, int, CountingInstrument&);
+
+/* Define SortOption type */
+typedef TypedSortOption<int> SortOption;
+
+/* Define BenchmarkConfig structure */
+struct BenchmarkConfig {
+    int warmupReps;
+    int measuredReps;
+    bool useHardwareCounters;
+    bool collectStats;
+    bool verify;
+};
+
+/* Define VerifyResult structure */
+struct VerifyResult {
+    bool ordered;
+    bool permutation;
+    bool stable;
+    VerifyResult() :ordered(true), permutation(true), stable(true) {}
+    bool passed(void) const { return ordered && permutation && stable; }
+    void merge(const VerifyResult& other)
+    {
+        ordered = ordered && other.ordered;
+        permutation = permutation && other.permutation;
+        stable = stable && other.stable;
+    }
+};
 
-/* Define SortFunction type */
-typedef void (*SortFunction)(int*, int);
+/* Define BenchmarkResult structure */
+struct BenchmarkResult {
+    double minTime;
+    double medianTime;
+    double p99Time;
+    double throughput;
+    bool statsValid;
+    SortStats stats;
+    bool verifyValid;
+    VerifyResult verify;
+    bool counterValid[HW_COUNTER_NUM];
+    unsigned long long counterValues[HW_COUNTER_NUM];
+};
 
-/* Define SortOption structure */
-struct SortOption {
-    SortFunction func;
+/* Define HardwareEvent structure */
+struct HardwareEvent {
+    unsigned int type;
+    unsigned long long config;
+    const char* name;
     const char* description;
 };
 
-/* Define static global variable */
-static unsigned int compareCount = 0;
+#ifdef __linux__
+/* Define the perf_event configuration of a read miss in a cache */
+#define HW_CACHE_READ_MISS(cache) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/* Define hardwareEvents array, cycles and instructions come first for the IPC */
+const HardwareEvent hardwareEvents[HW_COUNTER_NUM] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles", "周期数 Cycles" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions", "指令数 Instructions" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache_misses", "缓存未命中 Cache Misses" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch_misses", "分支预测失败 Branch Misses" },
+    { PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D), "l1d_misses", "L1D未命中 L1D Misses" },
+    { PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL), "llc_misses", "LLC未命中 LLC Misses" },
+    { PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB), "dtlb_misses", "dTLB未命中 dTLB Misses" }
+};
+#else
+/* Define hardwareEvents array, cycles and instructions come first for the IPC */
+const HardwareEvent hardwareEvents[HW_COUNTER_NUM] = {
+    { 0, 0, "cycles", "周期数 Cycles" },
+    { 0, 0, "instructions", "指令数 Instructions" },
+    { 0, 0, "cache_misses", "缓存未命中 Cache Misses" },
+    { 0, 0, "branch_misses", "分支预测失败 Branch Misses" },
+    { 0, 0, "l1d_misses", "L1D未命中 L1D Misses" },
+    { 0, 0, "llc_misses", "LLC未命中 LLC Misses" },
+    { 0, 0, "dtlb_misses", "dTLB未命中 dTLB Misses" }
+};
+#endif
+
+/* Define HardwareCounters class */
+class HardwareCounters {
+private:
+    int fds[HW_COUNTER_NUM];
+public:
+    HardwareCounters(bool enable);
+    ~HardwareCounters();
+    bool isValid(int index) const { return fds[index] >= 0; }
+    void start(void);
+    void stop(unsigned long long values[]);
+};
+
+/*
+ * Function Name:    HardwareCounters
+ * Function:         Open one perf_event counter per hardware event
+ * Input Parameters: bool enable
+ * Notes:            Class external implementation of member functions
+ *                   Counters that the kernel refuses (VM, perf_event_paranoid, missing event) stay invalid.
+ *                   The counters are not grouped, so the kernel may multiplex them on the PMU
+ */
+HardwareCounters::HardwareCounters(bool enable)
+{
+    for (int i = 0; i < HW_COUNTER_NUM; i++) {
+        fds[i] = -1;
+#ifdef __linux__
+        if (!enable)
+            continue;
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = hardwareEvents[i].type;
+        attr.config = hardwareEvents[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)enable;
+#endif
+    }
+}
+
+/*
+ * Function Name:    ~HardwareCounters
+ * Function:         Close the opened counters
+ * Notes:            Class external implementation of member functions
+ */
+HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        if (fds[i] >= 0)
+            close(fds[i]);
+#endif
+}
+
+/*
+ * Function Name:    start
+ * Function:         Reset and enable the counters
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void HardwareCounters::start(void)
+{
+#ifdef __linux__
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+}
+
+/*
+ * Function Name:    stop
+ * Function:         Disable the counters and read their values
+ * Input Parameters: unsigned long long values[]
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   A multiplexed counter is scaled up by the ratio of its enabled to its running time
+ */
+void HardwareCounters::stop(unsigned long long values[])
+{
+#ifdef __linux__
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        if (fds[i] >= 0)
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    for (int i = 0; i < HW_COUNTER_NUM; i++) {
+        values[i] = 0;
+#ifdef __linux__
+        unsigned long long data[3];
+        if (fds[i] >= 0 && read(fds[i], data, sizeof(data)) == sizeof(data) && data[2] > 0)
+            values[i] = data[2] == data[1] ? data[0] : static_cast<unsigned long long>(static_cast<double>(data[0]) * data[1] / data[2]);
+#endif
+    }
+}
+
+/* Define ParallelConfig structure */
+struct ParallelConfig {
+    int threadCount;
+    int sequentialCutoff;
+};
+
+/* Define ThreadPool class */
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::deque<std::function<void()> > tasks;
+        std::mutex mutex;
+    };
+    int threadNum;
+    WorkQueue* queues;
+    std::thread* workers;
+    bool stopping;
+    int pendingTasks;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCond;
+    static thread_local int queueIndex;
+    bool takeTask(std::function<void()>& task);
+    void workerLoop(int index);
+public:
+    ThreadPool(int _threadNum);
+    ~ThreadPool();
+    int size(void) const { return threadNum; }
+    void submit(std::function<void()> task);
+    bool runPendingTask(void);
+};
+
+/* Define the work queue index of the current thread */
+thread_local int ThreadPool::queueIndex = -1;
+
+/*
+ * Function Name:    ThreadPool
+ * Function:         Start _threadNum - 1 workers, the calling thread is the last participant
+ * Input Parameters: int _threadNum
+ * Notes:            Class external implementation of member functions
+ */
+ThreadPool::ThreadPool(int _threadNum) :threadNum(_threadNum), queues(NULL), workers(NULL), stopping(false), pendingTasks(0)
+{
+    queues = new(std::nothrow) WorkQueue[threadNum];
+    workers = new(std::nothrow) std::thread[threadNum];
+    if (queues == NULL || workers == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    for (int i = 0; i < threadNum - 1; i++)
+        workers[i] = std::thread(&ThreadPool::workerLoop, this, i);
+}
+
+/*
+ * Function Name:    ~ThreadPool
+ * Function:         Stop and join the workers
+ * Notes:            Class external implementation of member functions
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCond.notify_all();
+    for (int i = 0; i < threadNum - 1; i++)
+        workers[i].join();
+    delete[] workers;
+    delete[] queues;
+}
+
+/*
+ * Function Name:    submit
+ * Function:         Push a task to the back of the queue of the current thread
+ * Input Parameters: std::function<void()> task
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   Threads outside the pool share the last queue
+ */
+void ThreadPool::submit(std::function<void()> task)
+{
+    int index = queueIndex >= 0 ? queueIndex : threadNum - 1;
+    {
+        std::lock_guard<std::mutex> lock(queues[index].mutex);
+        queues[index].tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pendingTasks++;
+    }
+    sleepCond.notify_one();
+}
+
+/*
+ * Function Name:    takeTask
+ * Function:         Pop the newest task of the own queue, or steal the oldest task of another queue
+ * Input Parameters: std::function<void()>& task
+ * Return Value:     true / false
+ * Notes:            Class external implementation of member functions
+ */
+bool ThreadPool::takeTask(std::function<void()>& task)
+{
+    int self = queueIndex >= 0 ? queueIndex : threadNum - 1;
+    for (int k = 0; k < threadNum; k++) {
+        WorkQueue& queue = queues[(self + k) % threadNum];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            std::lock_guard<std::mutex> sleepLock(sleepMutex);
+            pendingTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Function Name:    runPendingTask
+ * Function:         Run one queued task on the calling thread
+ * Input Parameters: void
+ * Return Value:     true if a task was run / false
+ * Notes:            Class external implementation of member functions
+ */
+bool ThreadPool::runPendingTask(void)
+{
+    std::function<void()> task;
+    if (!takeTask(task))
+        return false;
+    task();
+    return true;
+}
+
+/*
+ * Function Name:    workerLoop
+ * Function:         Run tasks until the pool is stopped
+ * Input Parameters: int index
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void ThreadPool::workerLoop(int index)
+{
+    queueIndex = index;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCond.wait(lock, [this] { return stopping || pendingTasks > 0; });
+            if (stopping)
+                return;
+        }
+        runPendingTask();
+    }
+}
+
+/* Define TaskGroup class */
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<int> pending;
+public:
+    TaskGroup(ThreadPool& _pool) :pool(_pool), pending(0) {}
+    void run(std::function<void()> task);
+    void wait(void);
+};
+
+/*
+ * Function Name:    run
+ * Function:         Submit a task belonging to this group
+ * Input Parameters: std::function<void()> task
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void TaskGroup::run(std::function<void()> task)
+{
+    pending++;
+    pool.submit([this, task] {
+        task();
+        pending--;
+    });
+}
+
+/*
+ * Function Name:    wait
+ * Function:         Wait for the tasks of this group, running queued tasks meanwhile
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void TaskGroup::wait(void)
+{
+    while (pending > 0)
+        if (!pool.runPendingTask())
+            std::this_thread::yield();
+}
+
+/* Define static global variables */
+static ParallelConfig parallelConfig = { 0, 1 << 14 };
+
+/*
+ * Function Name:    getThreadPool
+ * Function:         Get the shared thread pool sized by parallelConfig.threadCount
+ * Input Parameters: void
+ * Return Value:     the thread pool
+ * Notes:            A thread count of 0 uses all hardware threads
+ */
+ThreadPool& getThreadPool(void)
+{
+    static std::unique_ptr<ThreadPool> pool;
+    int threadNum = parallelConfig.threadCount;
+    if (threadNum <= 0)
+        threadNum = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (!pool || pool->size() != threadNum)
+        pool.reset(new ThreadPool(threadNum));
+    return *pool;
+}
 
 /*
  * Function Name:    inputInteger
@@ -63,10 +619,11 @@ int inputInteger(int lowerLimit, int upperLimit, const char* prompt)
 /*
  * Function Name:    selectOptn
  * Function:         Select operation
- * Input Parameters: void
+ * Input Parameters: int optnNum
  * Return Value:     operation
+ * Notes:            Operations after 9 are selected with the keys a, b, c, ...
  */
-int selectOptn(void)
+int selectOptn(int optnNum)
 {
     std::cout << std::endl << "请选择排序算法: ";
     char optn;
@@ -91,10 +648,14 @@ int selectOptn(void)
             endwin();
 #endif
         }
-        else if (optn >= '0' && optn <= '8') {
+        else if (optn >= '0' && optn <= '9' && optn - '0' <= optnNum) {
             std::cout << "[" << optn << "]" << std::endl;
             return optn - '0';
         }
+        else if (optn >= 'a' && optn <= 'z' && optn - 'a' + 10 <= optnNum) {
+            std::cout << "[" << optn << "]" << std::endl;
+            return optn - 'a' + 10;
+        }
     }
 }
 
@@ -103,14 +664,16 @@ int selectOptn(void)
  * Function:         Swap function
  * Input Parameters: Type& a
  *                   Type& b
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void mySwap(Type& a, Type& b)
+template <typename Type, typename Instrument>
+void mySwap(Type& a, Type& b, Instrument& ins)
 {
     Type tmp = a;
     a = b;
     b = tmp;
+    ins.moved(3);
 }
 
 /*
@@ -118,17 +681,16 @@ void mySwap(Type& a, Type& b)
  * Function:         Bubble sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void bubbleSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void bubbleSort(Type arr[], int n, Instrument& ins)
 {
     for (int i = 0; i < n - 1; i++)
-        for (int j = 0; j < n - i - 1; j++) {
-            compareCount++;
-            if (arr[j] > arr[j + 1])
-                mySwap(arr[j], arr[j + 1]);
-        }
+        for (int j = 0; j < n - i - 1; j++)
+            if (ins.compare(arr[j] > arr[j + 1]))
+                mySwap(arr[j], arr[j + 1], ins);
 }
 
 /*
@@ -136,19 +698,18 @@ void bubbleSort(Type arr[], int n)
  * Function:         Selection sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void selectionSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void selectionSort(Type arr[], int n, Instrument& ins)
 {
     for (int i = 0; i < n - 1; i++) {
         int k = i;
-        for (int j = i + 1; j < n; j++) {
-            compareCount++;
-            if (arr[j] < arr[k])
+        for (int j = i + 1; j < n; j++)
+            if (ins.compare(arr[j] < arr[k]))
                 k = j;
-        }
-        mySwap(arr[k], arr[i]);
+        mySwap(arr[k], arr[i], ins);
     }
 }
 
@@ -157,42 +718,218 @@ void selectionSort(Type arr[], int n)
  * Function:         Insertion sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void insertionSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void insertionSort(Type arr[], int n, Instrument& ins)
 {
     for (int i = 1; i < n; i++) {
-        int key = arr[i], j = i - 1;
-        while (j >= 0 && arr[j] > key) {
-            compareCount++;
+        Type key = arr[i];
+        int j = i - 1;
+        while (j >= 0 && ins.compare(arr[j] > key)) {
             arr[j + 1] = arr[j];
+            ins.moved(1);
             j--;
         }
         arr[j + 1] = key;
+        ins.moved(2);
     }
 }
 
+/* Define GapSequence type, fills gaps[] with the ascending gaps below n and returns their count */
+typedef int (*GapSequence)(int n, int gaps[]);
+
 /*
- * Function Name:    shellSort
- * Function:         Shell sort
+ * Function Name:    halvingGaps
+ * Function:         Shell's original sequence n/2, n/4, ..., 1
+ * Input Parameters: int n
+ *                   int gaps[]
+ * Return Value:     the number of gaps
+ */
+int halvingGaps(int n, int gaps[])
+{
+    int count = 0;
+    for (int gap = n >> 1; gap > 0; gap >>= 1)
+        gaps[count++] = gap;
+    std::reverse(gaps, gaps + count);
+    return count;
+}
+
+/*
+ * Function Name:    ciuraGaps
+ * Function:         Ciura's empirical sequence, extended past 1750 by a factor of 2.25
+ * Input Parameters: int n
+ *                   int gaps[]
+ * Return Value:     the number of gaps
+ */
+int ciuraGaps(int n, int gaps[])
+{
+    static const int ciura[] = { 1, 4, 10, 23, 57, 132, 301, 701, 1750 };
+    int count = 0;
+    long long gap = 0;
+    for (int i = 0; i < static_cast<int>(sizeof(ciura) / sizeof(ciura[0])) && ciura[i] < n; i++)
+        gaps[count++] = static_cast<int>(gap = ciura[i]);
+    if (gap == ciura[sizeof(ciura) / sizeof(ciura[0]) - 1])
+        while ((gap = gap * 9 / 4) < n)
+            gaps[count++] = static_cast<int>(gap);
+    return count;
+}
+
+/*
+ * Function Name:    tokudaGaps
+ * Function:         Tokuda's sequence ceil((9 * (9/4)^k - 4) / 5)
+ * Input Parameters: int n
+ *                   int gaps[]
+ * Return Value:     the number of gaps
+ */
+int tokudaGaps(int n, int gaps[])
+{
+    int count = 0;
+    for (double power = 1.0;; power *= 2.25) {
+        double gap = std::ceil((9.0 * power - 4.0) / 5.0);
+        if (gap >= n)
+            break;
+        gaps[count++] = static_cast<int>(gap);
+    }
+    return count;
+}
+
+/*
+ * Function Name:    sedgewickGaps
+ * Function:         Sedgewick's 1986 sequence, 9 * 4^i - 9 * 2^i + 1 interleaved with 4^j - 3 * 2^j + 1
+ * Input Parameters: int n
+ *                   int gaps[]
+ * Return Value:     the number of gaps
+ * Notes:            O(n^(4/3)) worst case
+ */
+int sedgewickGaps(int n, int gaps[])
+{
+    int count = 0;
+    for (long long power = 1, gap; (gap = 9 * power * power - 9 * power + 1) < n; power <<= 1)
+        gaps[count++] = static_cast<int>(gap);
+    for (long long power = 4, gap; (gap = power * power - 3 * power + 1) < n; power <<= 1)
+        gaps[count++] = static_cast<int>(gap);
+    std::sort(gaps, gaps + count);
+    return count;
+}
+
+/*
+ * Function Name:    prattGaps
+ * Function:         Pratt's sequence of all 2^p * 3^q
+ * Input Parameters: int n
+ *                   int gaps[]
+ * Return Value:     the number of gaps
+ * Notes:            Θ(n log^2 n) in every case, since each pass moves an element at most one gap,
+ *                   but the many passes make it slow in practice
+ */
+int prattGaps(int n, int gaps[])
+{
+    int count = 0;
+    for (long long power3 = 1; power3 < n; power3 *= 3)
+        for (long long gap = power3; gap < n; gap <<= 1)
+            gaps[count++] = static_cast<int>(gap);
+    std::sort(gaps, gaps + count);
+    return count;
+}
+
+/*
+ * Function Name:    shellSortGaps
+ * Function:         Shell sort over the gaps produced by a gap sequence
  * Input Parameters: Type arr[]
  *                   int n
+ *                   GapSequence sequence
+ *                   Instrument& ins
  * Return Value:     void
+ * Notes:            The gaps live on the stack, so every sequence sorts in place with no allocation
  */
-template <typename Type>
-void shellSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void shellSortGaps(Type arr[], int n, GapSequence sequence, Instrument& ins)
 {
-    int gap, i, j;
-    for (gap = n >> 1; gap > 0; gap >>= 1)
+    int gaps[SHELL_MAX_GAPS];
+    int i, j, k = sequence(n, gaps);
+    while (k-- > 0) {
+        int gap = gaps[k];
         for (i = gap; i < n; i++) {
             Type tmp = arr[i];
-            for (j = i - gap; j >= 0 && arr[j] > tmp; j -= gap) {
-                compareCount++;
+            for (j = i - gap; j >= 0 && ins.compare(arr[j] > tmp); j -= gap) {
                 arr[j + gap] = arr[j];
+                ins.moved(1);
             }
             arr[j + gap] = tmp;
+            ins.moved(2);
         }
+    }
+}
+
+/*
+ * Function Name:    shellSort
+ * Function:         Shell sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void shellSort(Type arr[], int n, Instrument& ins)
+{
+    shellSortGaps(arr, n, halvingGaps, ins);
+}
+
+/*
+ * Function Name:    ciuraShellSort
+ * Function:         Shell sort with Ciura's gaps
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void ciuraShellSort(Type arr[], int n, Instrument& ins)
+{
+    shellSortGaps(arr, n, ciuraGaps, ins);
+}
+
+/*
+ * Function Name:    tokudaShellSort
+ * Function:         Shell sort with Tokuda's gaps
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void tokudaShellSort(Type arr[], int n, Instrument& ins)
+{
+    shellSortGaps(arr, n, tokudaGaps, ins);
+}
+
+/*
+ * Function Name:    sedgewickShellSort
+ * Function:         Shell sort with Sedgewick's gaps
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void sedgewickShellSort(Type arr[], int n, Instrument& ins)
+{
+    shellSortGaps(arr, n, sedgewickGaps, ins);
+}
+
+/*
+ * Function Name:    prattShellSort
+ * Function:         Shell sort with Pratt's gaps
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void prattShellSort(Type arr[], int n, Instrument& ins)
+{
+    shellSortGaps(arr, n, prattGaps, ins);
 }
 
 /*
@@ -201,19 +938,18 @@ void shellSort(Type arr[], int n)
  * Input Parameters: Type arr[]
  *                   int low
  *                   int high
+ *                   Instrument& ins
  * Return Value:     the index of the pivot element after partition
  */
-template <typename Type>
-int partition(Type arr[], int low, int high)
+template <typename Type, typename Instrument>
+int partition(Type arr[], int low, int high, Instrument& ins)
 {
     Type pivot = arr[high];
     int i = low - 1;
-    for (int j = low; j <= high - 1; j++) {
-        compareCount++;
-        if (arr[j] < pivot)
-            mySwap(arr[++i], arr[j]);
-    }
-    mySwap(arr[i + 1], arr[high]);
+    for (int j = low; j <= high - 1; j++)
+        if (ins.compare(arr[j] < pivot))
+            mySwap(arr[++i], arr[j], ins);
+    mySwap(arr[i + 1], arr[high], ins);
     return i + 1;
 }
 
@@ -223,15 +959,17 @@ int partition(Type arr[], int low, int high)
  * Input Parameters: Type arr[]
  *                   int low
  *                   int high
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void quickSort(Type arr[], int low, int high)
+template <typename Type, typename Instrument>
+void quickSort(Type arr[], int low, int high, Instrument& ins)
 {
+    DepthGuard<Instrument> guard(ins);
     if (low < high) {
-        int pi = partition(arr, low, high);
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
+        int pi = partition(arr, low, high, ins);
+        quickSort(arr, low, pi - 1, ins);
+        quickSort(arr, pi + 1, high, ins);
     }
 }
 
@@ -240,12 +978,13 @@ void quickSort(Type arr[], int low, int high)
  * Function:         Quick sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void quickSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void quickSort(Type arr[], int n, Instrument& ins)
 {
-    quickSort(arr, 0, n - 1);
+    quickSort(arr, 0, n - 1, ins);
 }
 
 /*
@@ -254,22 +993,21 @@ void quickSort(Type arr[], int n)
  * Input Parameters: Type arr[]
  *                   int n
  *                   int i
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void heapify(Type arr[], int n, int i)
+template <typename Type, typename Instrument>
+void heapify(Type arr[], int n, int i, Instrument& ins)
 {
+    DepthGuard<Instrument> guard(ins);
     int largest = i, left = 2 * i + 1, right = 2 * i + 2;
-    compareCount++;
-    if (left < n && arr[left] > arr[largest])
+    if (left < n && ins.compare(arr[left] > arr[largest]))
         largest = left;
-    compareCount++;
-    if (right < n && arr[right] > arr[largest])
+    if (right < n && ins.compare(arr[right] > arr[largest]))
         largest = right;
-    compareCount++;
     if (largest != i) {
-        mySwap(arr[i], arr[largest]);
-        heapify(arr, n, largest);
+        mySwap(arr[i], arr[largest], ins);
+        heapify(arr, n, largest, ins);
     }
 }
 
@@ -278,61 +1016,549 @@ void heapify(Type arr[], int n, int i)
  * Function:         Heap sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void heapSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void heapSort(Type arr[], int n, Instrument& ins)
 {
     for (int i = n / 2 - 1; i >= 0; i--)
-        heapify(arr, n, i);
+        heapify(arr, n, i, ins);
     for (int i = n - 1; i > 0; i--) {
-        mySwap(arr[0], arr[i]);
-        heapify(arr, i, 0);
+        mySwap(arr[0], arr[i], ins);
+        heapify(arr, i, 0, ins);
     }
 }
 
 /*
- * Function Name:    merge
- * Function:         Merge function
+ * Function Name:    bottomUpSiftDown
+ * Function:         Place x into the binary max heap arr[0..n) whose node i is a hole, Floyd/Wegener style
  * Input Parameters: Type arr[]
- *                   int left
- *                   int mid
- *                   int right
+ *                   int n
+ *                   int i
+ *                   const Type& x
+ *                   Instrument& ins
  * Return Value:     void
+ * Notes:            The hole is moved to a leaf along the path of larger children with one comparison per
+ *                   level, then x is sifted up from there. x usually belongs near the bottom, so this takes
+ *                   about half the comparisons of heapify
  */
-template <typename Type>
-void merge(Type arr[], int left, int mid, int right)
+template <typename Type, typename Instrument>
+void bottomUpSiftDown(Type arr[], int n, int i, const Type& x, Instrument& ins)
 {
-    int n1 = mid - left + 1, n2 = right - mid, i = 0, j = 0, k = left;
-    Type* leftArr = new(std::nothrow) Type[n1];
-    if (leftArr == NULL) {
-        std::cerr << "Error: Memory allocation failed." << std::endl;
-        exit(MEMORY_ALLOCATION_ERROR);
+    int hole = i, child;
+    while ((child = 2 * hole + 2) < n) {
+        child -= ins.compare(arr[child] < arr[child - 1]);
+        arr[hole] = arr[child];
+        ins.moved(1);
+        hole = child;
     }
-    Type* rightArr = new(std::nothrow) Type[n2];
-    if (rightArr == NULL) {
-        std::cerr << "Error: Memory allocation failed." << std::endl;
-        exit(MEMORY_ALLOCATION_ERROR);
+    if (child == n) {
+        arr[hole] = arr[n - 1];
+        ins.moved(1);
+        hole = n - 1;
     }
+    while (hole > i) {
+        int parent = (hole - 1) / 2;
+        if (!ins.compare(arr[parent] < x))
+            break;
+        arr[hole] = arr[parent];
+        ins.moved(1);
+        hole = parent;
+    }
+    arr[hole] = x;
+    ins.moved(1);
+}
+
+/*
+ * Function Name:    bottomUpHeapSort
+ * Function:         Bottom-up heap sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void bottomUpHeapSort(Type arr[], int n, Instrument& ins)
+{
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        Type x = arr[i];
+        bottomUpSiftDown(arr, n, i, x, ins);
+    }
+    for (int i = n - 1; i > 0; i--) {
+        Type x = arr[i];
+        arr[i] = arr[0];
+        ins.moved(2);
+        bottomUpSiftDown(arr, i, 0, x, ins);
+    }
+}
+
+/*
+ * Function Name:    heapAlignment
+ * Function:         Get how many leading elements to skip so that every child group of a Ways-ary heap
+ *                   starts on a boundary of Ways elements
+ * Input Parameters: const Type arr[]
+ *                   int n
+ * Return Value:     the offset of the heap root, below Ways
+ * Notes:            A child group then never straddles a cache line. Returns 0 when the group size is not a
+ *                   power of two or exceeds a cache line
+ */
+template <int Ways, typename Type>
+int heapAlignment(const Type arr[], int n)
+{
+    size_t group = Ways * sizeof(Type);
+    uintptr_t address = reinterpret_cast<uintptr_t>(arr);
+    if (group > CACHE_LINE_BYTES || (group & (group - 1)) != 0 || address % sizeof(Type) != 0)
+        return 0;
+    int misalignment = static_cast<int>(address / sizeof(Type) % Ways);
+    return std::min(n, (2 * Ways - 1 - misalignment) % Ways);
+}
+
+/*
+ * Function Name:    dAryPrefetchChildren
+ * Function:         Prefetch the grandchildren of node i in a Ways-ary heap
+ * Input Parameters: const Type heap[]
+ *                   int n
+ *                   int i
+ * Return Value:     void
+ * Notes:            The Ways * Ways grandchildren are contiguous, so one prefetch per cache line covers them
+ *                   while the children of node i are being compared
+ */
+template <int Ways, typename Type>
+inline void dAryPrefetchChildren(const Type heap[], int n, int i)
+{
+    long long first = (static_cast<long long>(i) * Ways + 1) * Ways + 1;
+    long long last = std::min(first + Ways * Ways, static_cast<long long>(n));
+    for (long long k = first; k < last; k += CACHE_LINE_BYTES / sizeof(Type) > 0 ? CACHE_LINE_BYTES / sizeof(Type) : 1)
+        PREFETCH(heap + k);
+}
+
+/*
+ * Function Name:    dArySiftDown
+ * Function:         Sift heap[i] down a Ways-ary max heap
+ * Input Parameters: Type heap[]
+ *                   int n
+ *                   int i
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The children of node i are heap[Ways * i + 1 .. Ways * i + Ways]. The shallower tree costs
+ *                   Ways - 1 comparisons per level but touches one cache line per level instead of two
+ */
+template <int Ways, bool Prefetch, typename Type, typename Instrument>
+void dArySiftDown(Type heap[], int n, int i, Instrument& ins)
+{
+    Type x = heap[i];
+    for (;;) {
+        long long first = static_cast<long long>(i) * Ways + 1;
+        if (first >= n)
+            break;
+        if (Prefetch)
+            dAryPrefetchChildren<Ways>(heap, n, i);
+        int last = static_cast<int>(std::min(first + Ways, static_cast<long long>(n)));
+        int largest = static_cast<int>(first);
+        for (int child = largest + 1; child < last; child++)
+            if (ins.compare(heap[largest] < heap[child]))
+                largest = child;
+        if (!ins.compare(x < heap[largest]))
+            break;
+        heap[i] = heap[largest];
+        ins.moved(1);
+        i = largest;
+    }
+    heap[i] = x;
+    ins.moved(2);
+}
+
+/*
+ * Function Name:    dAryHeapSort
+ * Function:         Ways-ary heap sort with cache-line-aligned child groups
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The heap starts after the few elements given by heapAlignment, which are inserted into the
+ *                   sorted tail at the end by binary search. A heap of fewer than two elements is already sorted
+ */
+template <int Ways, bool Prefetch, typename Type, typename Instrument>
+void dAryHeapSort(Type arr[], int n, Instrument& ins)
+{
+    int offset = heapAlignment<Ways>(arr, n);
+    Type* heap = arr + offset;
+    int size = n - offset;
+    if (size > 1) {
+        for (int i = (size - 2) / Ways; i >= 0; i--)
+            dArySiftDown<Ways, Prefetch>(heap, size, i, ins);
+        for (int i = size - 1; i > 0; i--) {
+            mySwap(heap[0], heap[i], ins);
+            dArySiftDown<Ways, Prefetch>(heap, i, 0, ins);
+        }
+    }
+    for (int k = offset - 1; k >= 0; k--) {
+        Type x = arr[k];
+        int left = k + 1, right = n;
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            if (ins.compare(arr[mid] < x))
+                left = mid + 1;
+            else
+                right = mid;
+        }
+        std::copy(arr + k + 1, arr + left, arr + k);
+        arr[left - 1] = x;
+        ins.moved(left - k + 1);
+    }
+}
+
+/*
+ * Function Name:    fourAryHeapSort
+ * Function:         4-ary heap sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void fourAryHeapSort(Type arr[], int n, Instrument& ins)
+{
+    dAryHeapSort<4, false>(arr, n, ins);
+}
+
+/*
+ * Function Name:    eightAryHeapSort
+ * Function:         8-ary heap sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void eightAryHeapSort(Type arr[], int n, Instrument& ins)
+{
+    dAryHeapSort<8, false>(arr, n, ins);
+}
+
+/*
+ * Function Name:    fourAryPrefetchHeapSort
+ * Function:         4-ary heap sort with grandchild prefetching
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void fourAryPrefetchHeapSort(Type arr[], int n, Instrument& ins)
+{
+    dAryHeapSort<4, true>(arr, n, ins);
+}
+
+/*
+ * Function Name:    eightAryPrefetchHeapSort
+ * Function:         8-ary heap sort with grandchild prefetching
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void eightAryPrefetchHeapSort(Type arr[], int n, Instrument& ins)
+{
+    dAryHeapSort<8, true>(arr, n, ins);
+}
+
+/*
+ * Function Name:    medianOfThree
+ * Function:         Find the median of three elements
+ * Input Parameters: Type arr[]
+ *                   int a
+ *                   int b
+ *                   int c
+ *                   Instrument& ins
+ * Return Value:     the index of the median element
+ */
+template <typename Type, typename Instrument>
+int medianOfThree(Type arr[], int a, int b, int c, Instrument& ins)
+{
+    if (ins.compare(arr[a] < arr[b])) {
+        if (ins.compare(arr[b] < arr[c]))
+            return b;
+        return ins.compare(arr[a] < arr[c]) ? c : a;
+    }
+    if (ins.compare(arr[a] < arr[c]))
+        return a;
+    return ins.compare(arr[b] < arr[c]) ? c : b;
+}
+
+/*
+ * Function Name:    choosePivot
+ * Function:         Move the median-of-three or ninther pivot to arr[low]
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The other candidates stay in (low, high] and act as sentinels for unguardedPartition
+ */
+template <typename Type, typename Instrument>
+void choosePivot(Type arr[], int low, int high, Instrument& ins)
+{
+    int n = high - low + 1, mid = low + n / 2, pivot;
+    if (n > NINTHER_THRESHOLD) {
+        int step = n / 8;
+        pivot = medianOfThree(arr,
+            medianOfThree(arr, low + 1, low + 1 + step, low + 1 + 2 * step, ins),
+            medianOfThree(arr, mid - step, mid, mid + step, ins),
+            medianOfThree(arr, high - 2 * step, high - step, high, ins), ins);
+    }
+    else
+        pivot = medianOfThree(arr, low + 1, mid, high, ins);
+    mySwap(arr[low], arr[pivot], ins);
+}
+
+/*
+ * Function Name:    unguardedPartition
+ * Function:         Hoare partition of arr[low + 1..high] around the pivot arr[low]
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   Instrument& ins
+ * Return Value:     the first index of the right part
+ */
+template <typename Type, typename Instrument>
+int unguardedPartition(Type arr[], int low, int high, Instrument& ins)
+{
+    Type pivot = arr[low];
+    int i = low + 1, j = high + 1;
+    while (true) {
+        while (ins.compare(arr[i] < pivot))
+            i++;
+        j--;
+        while (ins.compare(pivot < arr[j]))
+            j--;
+        if (i >= j)
+            return i;
+        mySwap(arr[i], arr[j], ins);
+        i++;
+    }
+}
+
+/*
+ * Function Name:    introSortLoop
+ * Function:         Partition arr[low..high] until the ranges are small or too deep
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   int depthLimit
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Recurse into the smaller part and loop on the larger one, so the stack depth stays O(log n)
+ */
+template <typename Type, typename Instrument>
+void introSortLoop(Type arr[], int low, int high, int depthLimit, Instrument& ins)
+{
+    DepthGuard<Instrument> guard(ins);
+    while (high - low + 1 > INTRO_SORT_THRESHOLD) {
+        if (depthLimit-- == 0) {
+            heapSort(arr + low, high - low + 1, ins);
+            return;
+        }
+        choosePivot(arr, low, high, ins);
+        int cut = unguardedPartition(arr, low, high, ins);
+        if (cut - low < high - cut + 1) {
+            introSortLoop(arr, low, cut - 1, depthLimit, ins);
+            low = cut;
+        }
+        else {
+            introSortLoop(arr, cut, high, depthLimit, ins);
+            high = cut - 1;
+        }
+    }
+}
+
+/*
+ * Function Name:    introSort
+ * Function:         Intro sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Quick sort with a median pivot, heap sort fallback at depth 2*log2(n) and a final insertion sort
+ */
+template <typename Type, typename Instrument>
+void introSort(Type arr[], int n, Instrument& ins)
+{
+    int depthLimit = 0;
+    for (int i = n; i > 1; i >>= 1)
+        depthLimit += 2;
+    introSortLoop(arr, 0, n - 1, depthLimit, ins);
+    insertionSort(arr, n, ins);
+}
+
+/*
+ * Function Name:    heapSelect
+ * Function:         Move the k-th smallest element of arr[0..n) to arr[k] with a bounded max heap
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   int k
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            arr[0..k] is kept as a max heap of the k + 1 smallest elements seen so far, so the input is
+ *                   read once as a stream with O(k) state. Afterwards arr[0..k) <= arr[k] <= arr[k + 1..n)
+ */
+template <typename Type, typename Instrument>
+void heapSelect(Type arr[], int n, int k, Instrument& ins)
+{
+    int size = k + 1;
+    for (int i = size / 2 - 1; i >= 0; i--)
+        heapify(arr, size, i, ins);
+    for (int i = size; i < n; i++)
+        if (ins.compare(arr[i] < arr[0])) {
+            mySwap(arr[0], arr[i], ins);
+            heapify(arr, size, 0, ins);
+        }
+    mySwap(arr[0], arr[k], ins);
+}
+
+/*
+ * Function Name:    introSelect
+ * Function:         Move the k-th smallest element of arr[0..n) to arr[k]
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   int k
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Quickselect with the intro sort pivot and partition, falling back to heapSelect after
+ *                   2*log2(n) partitions, so the expected O(n) never degrades beyond O(n log n)
+ */
+template <typename Type, typename Instrument>
+void introSelect(Type arr[], int n, int k, Instrument& ins)
+{
+    int low = 0, high = n - 1, depthLimit = 0;
+    for (int i = n; i > 1; i >>= 1)
+        depthLimit += 2;
+    while (high - low + 1 > INTRO_SORT_THRESHOLD) {
+        if (depthLimit-- == 0) {
+            heapSelect(arr + low, high - low + 1, k - low, ins);
+            return;
+        }
+        choosePivot(arr, low, high, ins);
+        int cut = unguardedPartition(arr, low, high, ins);
+        if (k < cut)
+            high = cut - 1;
+        else
+            low = cut;
+    }
+    insertionSort(arr + low, high - low + 1, ins);
+}
+
+/*
+ * Function Name:    floydRivestSelect
+ * Function:         Move the k-th smallest element of arr[left..right] to arr[k]
+ * Input Parameters: Type arr[]
+ *                   int left
+ *                   int right
+ *                   int k
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            For large ranges a sample of about n^(2/3) elements is selected recursively first, so the
+ *                   pivot lands just beside the k-th element and one partition discards nearly everything.
+ *                   The expected cost is n + min(k, n - k) + o(n) comparisons
+ */
+template <typename Type, typename Instrument>
+void floydRivestSelect(Type arr[], int left, int right, int k, Instrument& ins)
+{
+    DepthGuard<Instrument> guard(ins);
+    while (right > left) {
+        if (right - left > FLOYD_RIVEST_THRESHOLD) {
+            double n = right - left + 1, i = k - left + 1, z = std::log(n);
+            double s = 0.5 * std::exp(2 * z / 3);
+            double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+            int newLeft = std::max(left, static_cast<int>(k - i * s / n + sd));
+            int newRight = std::min(right, static_cast<int>(k + (n - i) * s / n + sd));
+            floydRivestSelect(arr, newLeft, newRight, k, ins);
+        }
+        Type pivot = arr[k];
+        int i = left, j = right;
+        mySwap(arr[left], arr[k], ins);
+        bool pivotLeft = ins.compare(pivot < arr[right]);
+        if (pivotLeft)
+            mySwap(arr[right], arr[left], ins);
+        while (i < j) {
+            mySwap(arr[i], arr[j], ins);
+            i++;
+            j--;
+            while (ins.compare(arr[i] < pivot))
+                i++;
+            while (ins.compare(pivot < arr[j]))
+                j--;
+        }
+        if (pivotLeft)
+            mySwap(arr[left], arr[j], ins);
+        else {
+            j++;
+            mySwap(arr[j], arr[right], ins);
+        }
+        if (j <= k)
+            left = j + 1;
+        if (k <= j)
+            right = j - 1;
+    }
+}
+
+/*
+ * Function Name:    floydRivestSelect
+ * Function:         Move the k-th smallest element of arr[0..n) to arr[k]
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   int k
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void floydRivestSelect(Type arr[], int n, int k, Instrument& ins)
+{
+    floydRivestSelect(arr, 0, n - 1, k, ins);
+}
+
+/*
+ * Function Name:    merge
+ * Function:         Merge function
+ * Input Parameters: Type arr[]
+ *                   int left
+ *                   int mid
+ *                   int right
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void merge(Type arr[], int left, int mid, int right, Instrument& ins)
+{
+    int n1 = mid - left + 1, n2 = right - mid, i = 0, j = 0, k = left;
+    Type* leftArr = new(std::nothrow) Type[n1];
+    if (leftArr == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    Type* rightArr = new(std::nothrow) Type[n2];
+    if (rightArr == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n1 + n2) * sizeof(Type));
     for (int i = 0; i < n1; i++)
         leftArr[i] = arr[left + i];
     for (int i = 0; i < n2; i++)
         rightArr[i] = arr[mid + 1 + i];
     while (i < n1 && j < n2) {
-        compareCount++;
-        if (leftArr[i] <= rightArr[j])
+        if (ins.compare(leftArr[i] <= rightArr[j]))
             arr[k++] = leftArr[i++];
         else
             arr[k++] = rightArr[j++];
     }
-    while (i < n1) {
-        compareCount++;
+    while (i < n1)
         arr[k++] = leftArr[i++];
-    }
-    while (j < n2) {
-        compareCount++;
+    while (j < n2)
         arr[k++] = rightArr[j++];
-    }
+    ins.moved(2 * static_cast<unsigned long long>(n1 + n2));
     delete[] leftArr;
     delete[] rightArr;
 }
@@ -343,16 +1569,18 @@ void merge(Type arr[], int left, int mid, int right)
  * Input Parameters: Type arr[]
  *                   int left
  *                   int right
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void mergeSort(Type arr[], int left, int right)
+template <typename Type, typename Instrument>
+void mergeSort(Type arr[], int left, int right, Instrument& ins)
 {
+    DepthGuard<Instrument> guard(ins);
     if (left < right) {
         int mid = left + (right - left) / 2;
-        mergeSort(arr, left, mid);
-        mergeSort(arr, mid + 1, right);
-        merge(arr, left, mid, right);
+        mergeSort(arr, left, mid, ins);
+        mergeSort(arr, mid + 1, right, ins);
+        merge(arr, left, mid, right, ins);
     }
 }
 
@@ -361,12 +1589,13 @@ void mergeSort(Type arr[], int left, int right)
  * Function:         Merge sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
  */
-template <typename Type>
-void mergeSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void mergeSort(Type arr[], int n, Instrument& ins)
 {
-    mergeSort(arr, 0, n - 1);
+    mergeSort(arr, 0, n - 1, ins);
 }
 
 /*
@@ -374,47 +1603,69 @@ void mergeSort(Type arr[], int n)
  * Function:         Get the maximum value
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     the maximum value
- * Notes:            Assume that all elements in the array are positive integers
  */
-template <typename Type>
-Type getMaxVal(Type arr[], int n)
+template <typename Type, typename Instrument>
+Type getMaxVal(Type arr[], int n, Instrument& ins)
 {
     Type maxVal = arr[0];
     for (int i = 1; i < n; i++)
-        if (arr[i] > maxVal)
+        if (ins.compare(arr[i] > maxVal))
             maxVal = arr[i];
     return maxVal;
 }
 
+/*
+ * Function Name:    getMinVal
+ * Function:         Get the minimum value
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     the minimum value
+ */
+template <typename Type, typename Instrument>
+Type getMinVal(Type arr[], int n, Instrument& ins)
+{
+    Type minVal = arr[0];
+    for (int i = 1; i < n; i++)
+        if (ins.compare(arr[i] < minVal))
+            minVal = arr[i];
+    return minVal;
+}
+
 /*
  * Function Name:    countSort
  * Function:         Perform counting sort for each digit
  * Input Parameters: Type arr[]
  *                   int n
- *                   int exp
+ *                   long long exp
+ *                   Instrument& ins
  * Return Value:     void
- * Notes:            Assume that all elements in the array are positive integers
+ * Notes:            The digit (arr[i] / exp) % 10 of a negative element is in -9..0, so the 19 buckets hold the
+ *                   digits -9..9 and negative elements sort before non-negative ones
  */
-template <typename Type>
-void countSort(Type arr[], int n, int exp)
+template <typename Type, typename Instrument>
+void countSort(Type arr[], int n, long long exp, Instrument& ins)
 {
     Type* output = new(std::nothrow) Type[n];
     if (output == NULL) {
         std::cerr << "Error: Memory allocation failed." << std::endl;
         exit(MEMORY_ALLOCATION_ERROR);
     }
-    int i, count[10] = { 0 };
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(Type));
+    int i, count[19] = { 0 };
     for (i = 0; i < n; i++)
-        count[(arr[i] / exp) % 10]++;
-    for (i = 1; i < 10; i++)
+        count[(arr[i] / exp) % 10 + 9]++;
+    for (i = 1; i < 19; i++)
         count[i] += count[i - 1];
     for (i = n - 1; i >= 0; i--) {
-        output[count[(arr[i] / exp) % 10] - 1] = arr[i];
-        count[(arr[i] / exp) % 10]--;
+        output[count[(arr[i] / exp) % 10 + 9] - 1] = arr[i];
+        count[(arr[i] / exp) % 10 + 9]--;
     }
     for (i = 0; i < n; i++)
         arr[i] = output[i];
+    ins.moved(2 * static_cast<unsigned long long>(n));
     delete[] output;
 }
 
@@ -423,75 +1674,4425 @@ void countSort(Type arr[], int n, int exp)
  * Function:         Radix sort
  * Input Parameters: Type arr[]
  *                   int n
+ *                   Instrument& ins
  * Return Value:     void
+ * Notes:            Signed keys are sorted by their signed decimal digits, the passes cover the longer of the
+ *                   minimum and the maximum
  */
-template <typename Type>
-void radixSort(Type arr[], int n)
+template <typename Type, typename Instrument>
+void radixSort(Type arr[], int n, Instrument& ins)
 {
-    Type maxVal = getMaxVal(arr, n);
-    for (int exp = 1; maxVal / exp > 0; exp *= 10)
-        countSort(arr, n, exp);
+    if (n <= 0)
+        return;
+    Type maxVal = getMaxVal(arr, n, ins);
+    Type minVal = getMinVal(arr, n, ins);
+    for (long long exp = 1; maxVal / exp > 0 || minVal / exp < 0; exp *= 10)
+        countSort(arr, n, exp, ins);
 }
 
-/* Define sortOptions array */
-SortOption sortOptions[] = {
-    { bubbleSort, "冒泡排序 Bubble Sort" },
-    { selectionSort, "选择排序 Selection Sort" },
-    { insertionSort, "插入排序 Insertion Sort" },
-    { shellSort, "希尔排序 Shell Sort" },
-    { quickSort, "快速排序 Quick Sort" },
-    { heapSort, "堆 排 序 Heap Sort" },
-    { mergeSort, "归并排序 Merge Sort" },
-    { radixSort, "基数排序 Radix Sort" }
+/* Define RadixKey structure template */
+template <typename Type>
+struct RadixKey;
+
+/* Define RadixKey structure for int */
+template <>
+struct RadixKey<int> {
+    typedef unsigned int Key;
+    static Key encode(int value) { return static_cast<unsigned int>(value) ^ 0x80000000u; }
+};
+
+/* Define RadixKey structure for unsigned int */
+template <>
+struct RadixKey<unsigned int> {
+    typedef unsigned int Key;
+    static Key encode(unsigned int value) { return value; }
+};
+
+/* Define RadixKey structure for long long */
+template <>
+struct RadixKey<long long> {
+    typedef unsigned long long Key;
+    static Key encode(long long value) { return static_cast<unsigned long long>(value) ^ 0x8000000000000000ULL; }
+};
+
+/* Define RadixKey structure for unsigned long long */
+template <>
+struct RadixKey<unsigned long long> {
+    typedef unsigned long long Key;
+    static Key encode(unsigned long long value) { return value; }
+};
+
+/* Define RadixKey structure for float */
+template <>
+struct RadixKey<float> {
+    typedef unsigned int Key;
+    static Key encode(float value)
+    {
+        unsigned int bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits ^ ((bits >> 31) ? 0xffffffffu : 0x80000000u);
+    }
+};
+
+/* Define RadixKey structure for double */
+template <>
+struct RadixKey<double> {
+    typedef unsigned long long Key;
+    static Key encode(double value)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits ^ ((bits >> 63) ? 0xffffffffffffffffULL : 0x8000000000000000ULL);
+    }
 };
 
 /*
- * Function Name:    performSort
- * Function:         Sort function
- * Input Parameters: SortFunction sortFunc
- *                   Type arr[]
- *                   int n
- *                   const char* prompt
- * Return Value:     void
+ * Function Name:    radixDigit
+ * Function:         Get the 8-bit digit d of a key
+ * Input Parameters: Key key
+ *                   int d
+ * Return Value:     the digit
  */
-template <typename Type>
-void performSort(SortFunction sortFunc, Type arr[], int n, const char* prompt)
+template <typename Key>
+inline unsigned int radixDigit(Key key, int d)
 {
-    compareCount = 0;
-    std::cout << std::endl << ">>> 排序算法: " << prompt << std::endl;
-    int* sortArr = new(std::nothrow) int[n];
-    if (sortArr == NULL) {
-        std::cerr << "Error: Memory allocation failed." << std::endl;
-        exit(MEMORY_ALLOCATION_ERROR);
-    }
-    std::copy(arr, arr + n, sortArr);
-#ifdef _WIN32
-    LARGE_INTEGER tick, begin, end;
-    QueryPerformanceFrequency(&tick);
-    QueryPerformanceCounter(&begin);
-#endif
-    sortFunc(sortArr, n);
-#ifdef _WIN32
-    QueryPerformanceCounter(&end);
-    std::cout << ">>> 排序时间: " << std::setiosflags(std::ios::fixed) << std::setprecision(6) << static_cast<double>(end.QuadPart - begin.QuadPart) / tick.QuadPart << "s" << std::endl;
-#endif
-    std::cout << ">>> 比较次数: " << compareCount << std::endl;
-    //std::cout << ">>> 排序数组: ";
-    //for (int i = 0; i < n; i++)
-    //    std::cout << sortArr[i] << " ";
-    //std::cout << std::endl;
-    delete[] sortArr;
+    return static_cast<unsigned int>(key >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1);
 }
 
 /*
- * Function Name:    main
- * Function:         Main function
- * Return Value:     0
+ * Function Name:    lsdRadixPasses
+ * Function:         Sort arr on its lowest digitNum 8-bit digits, alternating between arr and buffer
+ * Input Parameters: Type arr[]
+ *                   Type buffer[]
+ *                   int n
+ *                   int digitNum
+ *                   Instrument& ins
+ * Return Value:     arr or buffer, whichever holds the sorted result
+ * Notes:            All digit histograms are counted in one read pass and passes with a single bucket are skipped
  */
-int main()
+template <typename Type, typename Instrument>
+Type* lsdRadixPasses(Type arr[], Type buffer[], int n, int digitNum, Instrument& ins)
 {
-    /* Generate random number seed */
-    srand((unsigned int)(time(0)));
+    typedef typename RadixKey<Type>::Key Key;
+    unsigned int count[sizeof(Key)][RADIX_BUCKETS] = { { 0 } };
+    for (int i = 0; i < n; i++) {
+        Key key = RadixKey<Type>::encode(arr[i]);
+        for (int d = 0; d < digitNum; d++)
+            count[d][radixDigit(key, d)]++;
+    }
+    Type* src = arr;
+    for (int d = 0; d < digitNum; d++) {
+        unsigned int* bucket = count[d];
+        if (n == 0 || bucket[radixDigit(RadixKey<Type>::encode(arr[0]), d)] == static_cast<unsigned int>(n))
+            continue;
+        Type* dst = src == arr ? buffer : arr;
+        unsigned int offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            unsigned int size = bucket[b];
+            bucket[b] = offset;
+            offset += size;
+        }
+        for (int i = 0; i < n; i++)
+            dst[bucket[radixDigit(RadixKey<Type>::encode(src[i]), d)]++] = src[i];
+        ins.moved(n);
+        src = dst;
+    }
+    return src;
+}
+
+/*
+ * Function Name:    lsdRadixSort
+ * Function:         LSD radix sort on 8-bit digits
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            RadixKey maps signed integers and floats to unsigned keys with the same order
+ */
+template <typename Type, typename Instrument>
+void lsdRadixSort(Type arr[], int n, Instrument& ins)
+{
+    Type* buffer = new(std::nothrow) Type[n];
+    if (buffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(Type));
+    Type* result = lsdRadixPasses(arr, buffer, n, sizeof(typename RadixKey<Type>::Key) * 8 / RADIX_BITS, ins);
+    if (result != arr) {
+        std::copy(result, result + n, arr);
+        ins.moved(n);
+    }
+    delete[] buffer;
+}
+
+/* Define ParallelSortContext structure template */
+template <typename Instrument>
+struct ParallelSortContext {
+    ThreadPool& pool;
+    int cutoff;
+    Instrument& ins;
+    std::mutex mutex;
+    ParallelSortContext(ThreadPool& _pool, int _cutoff, Instrument& _ins) :pool(_pool), cutoff(_cutoff), ins(_ins) {}
+    void join(const Instrument& task)
+    {
+        if (Instrument::enabled) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ins.merge(task);
+        }
+    }
+};
+
+/*
+ * Function Name:    mergeRuns
+ * Function:         Stable merge of two sorted runs into out
+ * Input Parameters: const Type a[]
+ *                   int na
+ *                   const Type b[]
+ *                   int nb
+ *                   Type out[]
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void mergeRuns(const Type a[], int na, const Type b[], int nb, Type out[], Instrument& ins)
+{
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        bool takeB = ins.compare(b[j] < a[i]);
+        out[k++] = takeB ? b[j] : a[i];
+        j += takeB;
+        i += !takeB;
+    }
+    while (i < na)
+        out[k++] = a[i++];
+    while (j < nb)
+        out[k++] = b[j++];
+    ins.moved(na + nb);
+}
+
+/*
+ * Function Name:    coRank
+ * Function:         Find how many elements of a precede output position k of the stable merge of a and b
+ * Input Parameters: int k
+ *                   const Type a[]
+ *                   int na
+ *                   const Type b[]
+ *                   int nb
+ *                   Instrument& ins
+ * Return Value:     the number of elements taken from a
+ */
+template <typename Type, typename Instrument>
+int coRank(int k, const Type a[], int na, const Type b[], int nb, Instrument& ins)
+{
+    int low = std::max(0, k - nb), high = std::min(k, na);
+    while (low < high) {
+        int i = low + (high - low) / 2;
+        if (ins.compare(a[i] <= b[k - i - 1]))
+            low = i + 1;
+        else
+            high = i;
+    }
+    return low;
+}
+
+/*
+ * Function Name:    parallelMerge
+ * Function:         Merge two sorted runs by splitting the output into co-ranked segments
+ * Input Parameters: const Type a[]
+ *                   int na
+ *                   const Type b[]
+ *                   int nb
+ *                   Type out[]
+ *                   Instrument& ins
+ *                   ParallelSortContext<Instrument>& ctx
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void parallelMerge(const Type a[], int na, const Type b[], int nb, Type out[], Instrument& ins, ParallelSortContext<Instrument>& ctx)
+{
+    int total = na + nb;
+    int parts = std::min((total + ctx.cutoff - 1) / ctx.cutoff, 4 * ctx.pool.size());
+    TaskGroup group(ctx.pool);
+    for (int p = 0; p < parts; p++) {
+        int kBegin = static_cast<int>(static_cast<long long>(total) * p / parts);
+        int kEnd = static_cast<int>(static_cast<long long>(total) * (p + 1) / parts);
+        Instrument task = ins.fork();
+        group.run([=, &ctx]() mutable {
+            int iBegin = coRank(kBegin, a, na, b, nb, task), iEnd = coRank(kEnd, a, na, b, nb, task);
+            mergeRuns(a + iBegin, iEnd - iBegin, b + kBegin - iBegin, (kEnd - iEnd) - (kBegin - iBegin), out + kBegin, task);
+            ctx.join(task);
+        });
+    }
+    group.wait();
+}
+
+/*
+ * Function Name:    parallelMergeSort
+ * Function:         Sort src[low..high) with the result in dst when toDst is set, otherwise in src
+ * Input Parameters: Type src[]
+ *                   Type dst[]
+ *                   int low
+ *                   int high
+ *                   bool toDst
+ *                   Instrument& ins
+ *                   ParallelSortContext<Instrument>& ctx
+ * Return Value:     void
+ * Notes:            The halves are sorted into the other buffer so every level merges without copying back
+ */
+template <typename Type, typename Instrument>
+void parallelMergeSort(Type src[], Type dst[], int low, int high, bool toDst, Instrument& ins, ParallelSortContext<Instrument>& ctx)
+{
+    DepthGuard<Instrument> guard(ins);
+    int n = high - low;
+    if (n <= ctx.cutoff) {
+        mergeSort(src + low, n, ins);
+        if (toDst) {
+            std::copy(src + low, src + high, dst + low);
+            ins.moved(n);
+        }
+        return;
+    }
+    int mid = low + n / 2;
+    TaskGroup group(ctx.pool);
+    Instrument task = ins.fork();
+    group.run([=, &ctx]() mutable {
+        parallelMergeSort(src, dst, low, mid, !toDst, task, ctx);
+        ctx.join(task);
+    });
+    parallelMergeSort(src, dst, mid, high, !toDst, ins, ctx);
+    group.wait();
+    Type* from = toDst ? src : dst;
+    Type* to = toDst ? dst : src;
+    parallelMerge(from + low, mid - low, from + mid, high - mid, to + low, ins, ctx);
+}
+
+/*
+ * Function Name:    parallelMergeSort
+ * Function:         Parallel merge sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The calling thread keeps its own instrument, tasks join theirs into ins through ctx
+ */
+template <typename Type, typename Instrument>
+void parallelMergeSort(Type arr[], int n, Instrument& ins)
+{
+    Type* buffer = new(std::nothrow) Type[n];
+    if (buffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(Type));
+    Instrument local = ins.fork();
+    ParallelSortContext<Instrument> ctx(getThreadPool(), std::max(1, parallelConfig.sequentialCutoff), ins);
+    parallelMergeSort(arr, buffer, 0, n, false, local, ctx);
+    ins.merge(local);
+    delete[] buffer;
+}
+
+/*
+ * Function Name:    parallelQuickSort
+ * Function:         Partition arr[low..high] and sort the left parts as tasks of group
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   int depthLimit
+ *                   TaskGroup& group
+ *                   Instrument& ins
+ *                   ParallelSortContext<Instrument>& ctx
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void parallelQuickSort(Type arr[], int low, int high, int depthLimit, TaskGroup& group, Instrument& ins, ParallelSortContext<Instrument>& ctx)
+{
+    DepthGuard<Instrument> guard(ins);
+    while (high - low + 1 > ctx.cutoff) {
+        if (depthLimit-- == 0) {
+            heapSort(arr + low, high - low + 1, ins);
+            return;
+        }
+        choosePivot(arr, low, high, ins);
+        int cut = unguardedPartition(arr, low, high, ins);
+        Instrument task = ins.fork();
+        group.run([=, &group, &ctx]() mutable {
+            parallelQuickSort(arr, low, cut - 1, depthLimit, group, task, ctx);
+            ctx.join(task);
+        });
+        low = cut;
+    }
+    introSort(arr + low, high - low + 1, ins);
+}
+
+/*
+ * Function Name:    parallelQuickSort
+ * Function:         Parallel quick sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Uses the intro sort pivot and partition, ranges below the cutoff are intro sorted
+ */
+template <typename Type, typename Instrument>
+void parallelQuickSort(Type arr[], int n, Instrument& ins)
+{
+    int depthLimit = 0;
+    for (int i = n; i > 1; i >>= 1)
+        depthLimit += 2;
+    Instrument local = ins.fork();
+    ParallelSortContext<Instrument> ctx(getThreadPool(), std::max(INTRO_SORT_THRESHOLD, parallelConfig.sequentialCutoff), ins);
+    TaskGroup group(ctx.pool);
+    parallelQuickSort(arr, 0, n - 1, depthLimit, group, local, ctx);
+    group.wait();
+    ins.merge(local);
+}
+
+/*
+ * Function Name:    parallelRadixSort
+ * Function:         Parallel radix sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Every thread histograms its chunk, the most significant varying digit is scattered in parallel
+ *                   through per-thread prefix sums, then each bucket is finished by an independent LSD task
+ */
+template <typename Type, typename Instrument>
+void parallelRadixSort(Type arr[], int n, Instrument& ins)
+{
+    typedef typename RadixKey<Type>::Key Key;
+    const int digitNum = sizeof(Key) * 8 / RADIX_BITS;
+    ThreadPool& pool = getThreadPool();
+    int chunkNum = pool.size();
+    if (n <= std::max(1, parallelConfig.sequentialCutoff) || chunkNum == 1) {
+        lsdRadixSort(arr, n, ins);
+        return;
+    }
+    Type* buffer = new(std::nothrow) Type[n];
+    unsigned int(*count)[sizeof(Key)][RADIX_BUCKETS] = new(std::nothrow) unsigned int[chunkNum][sizeof(Key)][RADIX_BUCKETS];
+    if (buffer == NULL || count == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(Type) + chunkNum * sizeof(count[0]));
+    TaskGroup group(pool);
+    for (int c = 0; c < chunkNum; c++)
+        group.run([=] {
+            int begin = static_cast<int>(static_cast<long long>(n) * c / chunkNum), end = static_cast<int>(static_cast<long long>(n) * (c + 1) / chunkNum);
+            memset(count[c], 0, sizeof(count[c]));
+            for (int i = begin; i < end; i++) {
+                Key key = RadixKey<Type>::encode(arr[i]);
+                for (int d = 0; d < digitNum; d++)
+                    count[c][d][radixDigit(key, d)]++;
+            }
+        });
+    group.wait();
+    int msd = digitNum - 1;
+    for (; msd > 0; msd--) {
+        unsigned int total = 0;
+        unsigned int digit = radixDigit(RadixKey<Type>::encode(arr[0]), msd);
+        for (int c = 0; c < chunkNum; c++)
+            total += count[c][msd][digit];
+        if (total != static_cast<unsigned int>(n))
+            break;
+    }
+    unsigned int bucketBegin[RADIX_BUCKETS + 1], offset = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+        bucketBegin[b] = offset;
+        for (int c = 0; c < chunkNum; c++) {
+            unsigned int size = count[c][msd][b];
+            count[c][msd][b] = offset;
+            offset += size;
+        }
+    }
+    bucketBegin[RADIX_BUCKETS] = offset;
+    for (int c = 0; c < chunkNum; c++)
+        group.run([=] {
+            int begin = static_cast<int>(static_cast<long long>(n) * c / chunkNum), end = static_cast<int>(static_cast<long long>(n) * (c + 1) / chunkNum);
+            unsigned int* bucket = count[c][msd];
+            for (int i = begin; i < end; i++)
+                buffer[bucket[radixDigit(RadixKey<Type>::encode(arr[i]), msd)]++] = arr[i];
+        });
+    group.wait();
+    ins.moved(n);
+    ParallelSortContext<Instrument> ctx(pool, 0, ins);
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+        unsigned int begin = bucketBegin[b], size = bucketBegin[b + 1] - begin;
+        if (size > 0) {
+            Instrument task = ins.fork();
+            group.run([=, &ctx]() mutable {
+                Type* result = lsdRadixPasses(buffer + begin, arr + begin, size, msd, task);
+                if (result != arr + begin) {
+                    std::copy(result, result + size, arr + begin);
+                    task.moved(size);
+                }
+                ctx.join(task);
+            });
+        }
+    }
+    group.wait();
+    delete[] count;
+    delete[] buffer;
+}
+
+/*
+ * Function Name:    mergePass
+ * Function:         Merge adjacent pairs of sorted runs of width elements from src into dst
+ * Input Parameters: const Type src[]
+ *                   Type dst[]
+ *                   int low
+ *                   int high
+ *                   int width
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            A trailing run without a partner is copied
+ */
+template <typename Type, typename Instrument>
+void mergePass(const Type src[], Type dst[], int low, int high, int width, Instrument& ins)
+{
+    for (int start = low; start < high; start += 2 * width) {
+        int mid = std::min(start + width, high), end = mid + std::min(width, high - mid);
+        mergeRuns(src + start, mid - start, src + mid, end - mid, dst + start, ins);
+    }
+}
+
+/*
+ * Function Name:    mergeWinner
+ * Function:         Get the run whose head comes first among runs i and j
+ * Input Parameters: const Type* head[]
+ *                   const Type* end[]
+ *                   int i
+ *                   int j
+ *                   Instrument& ins
+ * Return Value:     the run index, or -1 when both runs are empty
+ * Notes:            i < j and ties go to i, which keeps the merge stable
+ */
+template <typename Type, typename Instrument>
+inline int mergeWinner(const Type* head[], const Type* end[], int i, int j, Instrument& ins)
+{
+    if (head[i] == end[i])
+        return head[j] == end[j] ? -1 : j;
+    if (head[j] == end[j])
+        return i;
+    return ins.compare(*head[j] < *head[i]) ? j : i;
+}
+
+/*
+ * Function Name:    mergePass4
+ * Function:         Merge groups of four sorted runs of width elements from src into dst
+ * Input Parameters: const Type src[]
+ *                   Type dst[]
+ *                   int low
+ *                   int high
+ *                   int width
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            While all four runs are non-empty the heads are kept in registers and the winner is selected
+ *                   without branches, the tail merges through the cached winners of runs 0/1 and 2/3.
+ *                   The data crosses memory half as often as with two-way passes
+ */
+template <typename Type, typename Instrument>
+void mergePass4(const Type src[], Type dst[], int low, int high, int width, Instrument& ins)
+{
+    for (int start = low; start < high; start += 4 * width) {
+        const Type* head[4];
+        const Type* end[4];
+        for (int r = 0; r < 4; r++) {
+            head[r] = src + std::min(start + r * width, high);
+            end[r] = src + std::min(start + (r + 1) * width, high);
+        }
+        Type* out = dst + start;
+        const Type* h0 = head[0], * h1 = head[1], * h2 = head[2], * h3 = head[3];
+        while (h0 != end[0] && h1 != end[1] && h2 != end[2] && h3 != end[3]) {
+            bool take1 = ins.compare(*h1 < *h0), take3 = ins.compare(*h3 < *h2);
+            const Type* x = take1 ? h1 : h0, * y = take3 ? h3 : h2;
+            bool takeY = ins.compare(*y < *x);
+            *out++ = takeY ? *y : *x;
+            h0 += !takeY & !take1;
+            h1 += !takeY & take1;
+            h2 += takeY & !take3;
+            h3 += takeY & take3;
+        }
+        head[0] = h0;
+        head[1] = h1;
+        head[2] = h2;
+        head[3] = h3;
+        int low01 = mergeWinner(head, end, 0, 1, ins), low23 = mergeWinner(head, end, 2, 3, ins);
+        while (true) {
+            int w;
+            if (low01 < 0)
+                w = low23;
+            else if (low23 < 0)
+                w = low01;
+            else
+                w = ins.compare(*head[low23] < *head[low01]) ? low23 : low01;
+            if (w < 0)
+                break;
+            *out++ = *head[w]++;
+            if (w < 2)
+                low01 = mergeWinner(head, end, 0, 1, ins);
+            else
+                low23 = mergeWinner(head, end, 2, 3, ins);
+        }
+        ins.moved(out - (dst + start));
+    }
+}
+
+/*
+ * Function Name:    bottomUpMergeSort
+ * Function:         Bottom-up merge sort with one auxiliary buffer
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   int ways
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Runs of MERGE_RUN_LENGTH are insertion sorted, then every block of at most MERGE_BLOCK_BYTES
+ *                   is merged to completion while it is hot in L1, and the passes over the whole array follow.
+ *                   Every pass ping-pongs between arr and the buffer, ways is 2 or 4
+ */
+template <typename Type, typename Instrument>
+void bottomUpMergeSort(Type arr[], int n, int ways, Instrument& ins)
+{
+    for (int start = 0; start < n; start += MERGE_RUN_LENGTH)
+        insertionSort(arr + start, std::min(MERGE_RUN_LENGTH, n - start), ins);
+    if (n <= MERGE_RUN_LENGTH)
+        return;
+    Type* buffer = new(std::nothrow) Type[n];
+    if (buffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(Type));
+    int blockLength = MERGE_RUN_LENGTH, blockPasses = 0;
+    while (static_cast<long long>(blockLength) * ways * sizeof(Type) <= MERGE_BLOCK_BYTES && blockLength < n) {
+        blockLength *= ways;
+        blockPasses++;
+    }
+    for (int block = 0; block < n; block += blockLength) {
+        int blockEnd = std::min(block + blockLength, n);
+        Type* src = arr, * dst = buffer;
+        for (int pass = 0, width = MERGE_RUN_LENGTH; pass < blockPasses; pass++, width *= ways) {
+            if (ways == 4)
+                mergePass4(src, dst, block, blockEnd, width, ins);
+            else
+                mergePass(src, dst, block, blockEnd, width, ins);
+            std::swap(src, dst);
+        }
+    }
+    Type* src = blockPasses % 2 == 0 ? arr : buffer, * dst = blockPasses % 2 == 0 ? buffer : arr;
+    for (long long width = blockLength; width < n; width *= ways) {
+        if (ways == 4)
+            mergePass4(src, dst, 0, n, static_cast<int>(width), ins);
+        else
+            mergePass(src, dst, 0, n, static_cast<int>(width), ins);
+        std::swap(src, dst);
+    }
+    if (src != arr) {
+        std::copy(src, src + n, arr);
+        ins.moved(n);
+    }
+    delete[] buffer;
+}
+
+/*
+ * Function Name:    bottomUpMergeSort
+ * Function:         Bottom-up two-way merge sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void bottomUpMergeSort(Type arr[], int n, Instrument& ins)
+{
+    bottomUpMergeSort(arr, n, 2, ins);
+}
+
+/*
+ * Function Name:    fourWayMergeSort
+ * Function:         Bottom-up four-way merge sort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void fourWayMergeSort(Type arr[], int n, Instrument& ins)
+{
+    bottomUpMergeSort(arr, n, 4, ins);
+}
+
+/* Define TimSortContext structure template */
+template <typename Type, typename Instrument>
+struct TimSortContext {
+    Type* arr;
+    Type* buffer;
+    int minGallop;
+    int runNum;
+    int runBase[TIM_SORT_MAX_RUNS];
+    int runLength[TIM_SORT_MAX_RUNS];
+    Instrument& ins;
+    TimSortContext(Type _arr[], Type _buffer[], Instrument& _ins) :arr(_arr), buffer(_buffer), minGallop(TIM_SORT_MIN_GALLOP), runNum(0), ins(_ins) {}
+};
+
+/*
+ * Function Name:    timMinRun
+ * Function:         Get the minimum run length for n elements
+ * Input Parameters: int n
+ * Return Value:     a length in [TIM_SORT_MIN_MERGE / 2, TIM_SORT_MIN_MERGE] for large n, or n itself
+ * Notes:            Chosen so that n / minRun is a power of two or slightly less, which balances the merges
+ */
+inline int timMinRun(int n)
+{
+    int r = 0;
+    while (n >= TIM_SORT_MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/*
+ * Function Name:    timCountRun
+ * Function:         Get the length of the run starting at arr[low] and make it ascending
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   Instrument& ins
+ * Return Value:     the run length
+ * Notes:            Only strictly descending runs are reversed, so equal elements keep their order
+ */
+template <typename Type, typename Instrument>
+int timCountRun(Type arr[], int low, int high, Instrument& ins)
+{
+    int end = low + 1;
+    if (end == high)
+        return 1;
+    if (ins.compare(arr[end] < arr[low])) {
+        while (++end < high && ins.compare(arr[end] < arr[end - 1]))
+            ;
+        std::reverse(arr + low, arr + end);
+        ins.moved(end - low);
+    }
+    else
+        while (++end < high && !ins.compare(arr[end] < arr[end - 1]))
+            ;
+    return end - low;
+}
+
+/*
+ * Function Name:    binaryInsertionSort
+ * Function:         Extend the sorted prefix arr[low..start) to arr[low..high)
+ * Input Parameters: Type arr[]
+ *                   int low
+ *                   int high
+ *                   int start
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Each element is placed after its equals, which keeps the sort stable
+ */
+template <typename Type, typename Instrument>
+void binaryInsertionSort(Type arr[], int low, int high, int start, Instrument& ins)
+{
+    for (; start < high; start++) {
+        Type pivot = arr[start];
+        int left = low, right = start;
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            if (ins.compare(pivot < arr[mid]))
+                right = mid;
+            else
+                left = mid + 1;
+        }
+        std::copy_backward(arr + left, arr + start, arr + start + 1);
+        arr[left] = pivot;
+        ins.moved(start - left + 2);
+    }
+}
+
+/*
+ * Function Name:    gallopLeft
+ * Function:         Find the leftmost position of key in the sorted arr[0..n), searching outward from hint
+ * Input Parameters: const Type& key
+ *                   const Type arr[]
+ *                   int n
+ *                   int hint
+ *                   Instrument& ins
+ * Return Value:     k such that arr[k - 1] < key <= arr[k]
+ * Notes:            Exponential search brackets the position in O(log d) comparisons for a distance d from hint,
+ *                   then a binary search finishes inside the bracket
+ */
+template <typename Type, typename Instrument>
+int gallopLeft(const Type& key, const Type arr[], int n, int hint, Instrument& ins)
+{
+    int lastOffset = 0, offset = 1;
+    if (ins.compare(arr[hint] < key)) {
+        int maxOffset = n - hint;
+        while (offset < maxOffset && ins.compare(arr[hint + offset] < key)) {
+            lastOffset = offset;
+            offset = offset <= (INT_MAX - 1) / 2 ? (offset << 1) + 1 : maxOffset;
+        }
+        offset = std::min(offset, maxOffset);
+        lastOffset += hint;
+        offset += hint;
+    }
+    else {
+        int maxOffset = hint + 1;
+        while (offset < maxOffset && !ins.compare(arr[hint - offset] < key)) {
+            lastOffset = offset;
+            offset = offset <= (INT_MAX - 1) / 2 ? (offset << 1) + 1 : maxOffset;
+        }
+        offset = std::min(offset, maxOffset);
+        int k = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - k;
+    }
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        if (ins.compare(arr[mid] < key))
+            lastOffset = mid + 1;
+        else
+            offset = mid;
+    }
+    return offset;
+}
+
+/*
+ * Function Name:    gallopRight
+ * Function:         Find the rightmost position of key in the sorted arr[0..n), searching outward from hint
+ * Input Parameters: const Type& key
+ *                   const Type arr[]
+ *                   int n
+ *                   int hint
+ *                   Instrument& ins
+ * Return Value:     k such that arr[k - 1] <= key < arr[k]
+ */
+template <typename Type, typename Instrument>
+int gallopRight(const Type& key, const Type arr[], int n, int hint, Instrument& ins)
+{
+    int lastOffset = 0, offset = 1;
+    if (ins.compare(key < arr[hint])) {
+        int maxOffset = hint + 1;
+        while (offset < maxOffset && ins.compare(key < arr[hint - offset])) {
+            lastOffset = offset;
+            offset = offset <= (INT_MAX - 1) / 2 ? (offset << 1) + 1 : maxOffset;
+        }
+        offset = std::min(offset, maxOffset);
+        int k = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - k;
+    }
+    else {
+        int maxOffset = n - hint;
+        while (offset < maxOffset && !ins.compare(key < arr[hint + offset])) {
+            lastOffset = offset;
+            offset = offset <= (INT_MAX - 1) / 2 ? (offset << 1) + 1 : maxOffset;
+        }
+        offset = std::min(offset, maxOffset);
+        lastOffset += hint;
+        offset += hint;
+    }
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        if (ins.compare(key < arr[mid]))
+            offset = mid;
+        else
+            lastOffset = mid + 1;
+    }
+    return offset;
+}
+
+/*
+ * Function Name:    timMergeLow
+ * Function:         Merge the adjacent runs a and b when a is the shorter one
+ * Input Parameters: TimSortContext<Type, Instrument>& ctx
+ *                   Type* a
+ *                   int na
+ *                   Type* b
+ *                   int nb
+ * Return Value:     void
+ * Notes:            a is moved to the buffer and the merge fills the array from the left. After minGallop
+ *                   consecutive wins of one run the merge gallops, and minGallop adapts to how well that pays off
+ */
+template <typename Type, typename Instrument>
+void timMergeLow(TimSortContext<Type, Instrument>& ctx, Type* a, int na, Type* b, int nb)
+{
+    Instrument& ins = ctx.ins;
+    std::copy(a, a + na, ctx.buffer);
+    ins.moved(na);
+    Type* cursorA = ctx.buffer, * endA = ctx.buffer + na, * cursorB = b, * endB = b + nb, * dest = a;
+    int countA = 0, countB = 0;
+    while (cursorA < endA && cursorB < endB) {
+        if (countA < ctx.minGallop && countB < ctx.minGallop) {
+            bool takeB = ins.compare(*cursorB < *cursorA);
+            *dest++ = takeB ? *cursorB++ : *cursorA++;
+            ins.moved(1);
+            countB = takeB ? countB + 1 : 0;
+            countA = takeB ? 0 : countA + 1;
+            continue;
+        }
+        countA = gallopRight(*cursorB, cursorA, static_cast<int>(endA - cursorA), 0, ins);
+        dest = std::copy(cursorA, cursorA + countA, dest);
+        cursorA += countA;
+        if (cursorA == endA)
+            break;
+        *dest++ = *cursorB++;
+        if (cursorB == endB)
+            break;
+        countB = gallopLeft(*cursorA, cursorB, static_cast<int>(endB - cursorB), 0, ins);
+        dest = std::copy(cursorB, cursorB + countB, dest);
+        cursorB += countB;
+        if (cursorB == endB)
+            break;
+        *dest++ = *cursorA++;
+        ins.moved(countA + countB + 2);
+        ctx.minGallop -= ctx.minGallop > 1;
+        if (countA < TIM_SORT_MIN_GALLOP && countB < TIM_SORT_MIN_GALLOP) {
+            ctx.minGallop++;
+            countA = countB = 0;
+        }
+    }
+    ins.moved(endA - cursorA);
+    std::copy(cursorA, endA, dest);
+}
+
+/*
+ * Function Name:    timMergeHigh
+ * Function:         Merge the adjacent runs a and b when b is the shorter one
+ * Input Parameters: TimSortContext<Type, Instrument>& ctx
+ *                   Type* a
+ *                   int na
+ *                   Type* b
+ *                   int nb
+ * Return Value:     void
+ * Notes:            Mirror image of timMergeLow: b is moved to the buffer and the array is filled from the right
+ */
+template <typename Type, typename Instrument>
+void timMergeHigh(TimSortContext<Type, Instrument>& ctx, Type* a, int na, Type* b, int nb)
+{
+    Instrument& ins = ctx.ins;
+    std::copy(b, b + nb, ctx.buffer);
+    ins.moved(nb);
+    Type* cursorA = a + na, * cursorB = ctx.buffer + nb, * dest = b + nb;
+    int countA = 0, countB = 0;
+    while (cursorA > a && cursorB > ctx.buffer) {
+        if (countA < ctx.minGallop && countB < ctx.minGallop) {
+            bool takeA = ins.compare(*(cursorB - 1) < *(cursorA - 1));
+            *--dest = takeA ? *--cursorA : *--cursorB;
+            ins.moved(1);
+            countA = takeA ? countA + 1 : 0;
+            countB = takeA ? 0 : countB + 1;
+            continue;
+        }
+        int lengthA = static_cast<int>(cursorA - a);
+        countA = lengthA - gallopRight(*(cursorB - 1), a, lengthA, lengthA - 1, ins);
+        dest = std::copy_backward(cursorA - countA, cursorA, dest);
+        cursorA -= countA;
+        if (cursorA == a)
+            break;
+        *--dest = *--cursorB;
+        if (cursorB == ctx.buffer)
+            break;
+        int lengthB = static_cast<int>(cursorB - ctx.buffer);
+        countB = lengthB - gallopLeft(*(cursorA - 1), ctx.buffer, lengthB, lengthB - 1, ins);
+        dest = std::copy_backward(cursorB - countB, cursorB, dest);
+        cursorB -= countB;
+        if (cursorB == ctx.buffer)
+            break;
+        *--dest = *--cursorA;
+        ins.moved(countA + countB + 2);
+        ctx.minGallop -= ctx.minGallop > 1;
+        if (countA < TIM_SORT_MIN_GALLOP && countB < TIM_SORT_MIN_GALLOP) {
+            ctx.minGallop++;
+            countA = countB = 0;
+        }
+    }
+    ins.moved(cursorB - ctx.buffer);
+    std::copy_backward(ctx.buffer, cursorB, dest);
+}
+
+/*
+ * Function Name:    timMergeAt
+ * Function:         Merge the runs at stack positions i and i + 1
+ * Input Parameters: TimSortContext<Type, Instrument>& ctx
+ *                   int i
+ * Return Value:     void
+ * Notes:            The prefix of a that is not greater than b[0] and the suffix of b that is not less than
+ *                   the last element of a are already in place and are skipped by galloping
+ */
+template <typename Type, typename Instrument>
+void timMergeAt(TimSortContext<Type, Instrument>& ctx, int i)
+{
+    Type* a = ctx.arr + ctx.runBase[i];
+    Type* b = ctx.arr + ctx.runBase[i + 1];
+    int na = ctx.runLength[i], nb = ctx.runLength[i + 1];
+    ctx.runLength[i] = na + nb;
+    for (int j = i + 1; j < ctx.runNum - 1; j++) {
+        ctx.runBase[j] = ctx.runBase[j + 1];
+        ctx.runLength[j] = ctx.runLength[j + 1];
+    }
+    ctx.runNum--;
+    int k = gallopRight(*b, a, na, 0, ctx.ins);
+    a += k;
+    na -= k;
+    if (na == 0)
+        return;
+    nb = gallopLeft(a[na - 1], b, nb, nb - 1, ctx.ins);
+    if (nb == 0)
+        return;
+    if (na <= nb)
+        timMergeLow(ctx, a, na, b, nb);
+    else
+        timMergeHigh(ctx, a, na, b, nb);
+}
+
+/*
+ * Function Name:    timMergeCollapse
+ * Function:         Merge the top runs until the run stack invariants hold again
+ * Input Parameters: TimSortContext<Type, Instrument>& ctx
+ * Return Value:     void
+ * Notes:            Every run is longer than the sum of the two above it and longer than the one above it,
+ *                   checked for the top four runs so the invariant holds for the whole stack
+ */
+template <typename Type, typename Instrument>
+void timMergeCollapse(TimSortContext<Type, Instrument>& ctx)
+{
+    const int* length = ctx.runLength;
+    while (ctx.runNum > 1) {
+        int i = ctx.runNum - 2;
+        if ((i > 0 && length[i - 1] <= length[i] + length[i + 1]) || (i > 1 && length[i - 2] <= length[i - 1] + length[i])) {
+            if (length[i - 1] < length[i + 1])
+                i--;
+        }
+        else if (length[i] > length[i + 1])
+            break;
+        timMergeAt(ctx, i);
+    }
+}
+
+/*
+ * Function Name:    timSort
+ * Function:         Adaptive natural merge sort in the style of TimSort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Natural runs are detected and extended to the minimum run length by binary insertion, then
+ *                   merged on a balanced run stack with galloping. Sorted input costs n - 1 comparisons, and a
+ *                   sorted prefix with a short unsorted tail costs O(n + t log n) for a tail of t elements
+ */
+template <typename Type, typename Instrument>
+void timSort(Type arr[], int n, Instrument& ins)
+{
+    if (n < 2)
+        return;
+    int minRun = timMinRun(n);
+    Type* buffer = NULL;
+    if (n > minRun) {
+        buffer = new(std::nothrow) Type[n / 2];
+        if (buffer == NULL) {
+            std::cerr << "Error: Memory allocation failed." << std::endl;
+            exit(MEMORY_ALLOCATION_ERROR);
+        }
+        ins.allocated(static_cast<unsigned long long>(n / 2) * sizeof(Type));
+    }
+    TimSortContext<Type, Instrument> ctx(arr, buffer, ins);
+    for (int low = 0; low < n;) {
+        int length = timCountRun(arr, low, n, ins);
+        if (length < minRun) {
+            int forced = std::min(minRun, n - low);
+            binaryInsertionSort(arr, low, low + forced, low + length, ins);
+            length = forced;
+        }
+        ctx.runBase[ctx.runNum] = low;
+        ctx.runLength[ctx.runNum] = length;
+        ctx.runNum++;
+        timMergeCollapse(ctx);
+        low += length;
+    }
+    while (ctx.runNum > 1) {
+        int i = ctx.runNum - 2;
+        if (i > 0 && ctx.runLength[i - 1] < ctx.runLength[i + 1])
+            i--;
+        timMergeAt(ctx, i);
+    }
+    delete[] buffer;
+}
+
+/*
+ * Function Name:    radixArgsort
+ * Function:         Get the stable permutation that sorts keys with an LSD radix sort
+ * Input Parameters: const Type keys[]
+ *                   unsigned int perm[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            keys[perm[0]] <= keys[perm[1]] <= ... afterwards, keys itself is not modified. The encoded keys
+ *                   and the 32-bit row ids are scattered together as two arrays, so a pass moves 4 bytes of row
+ *                   id per key whatever the payload of the rows is
+ */
+template <typename Type, typename Instrument>
+void radixArgsort(const Type keys[], unsigned int perm[], int n, Instrument& ins)
+{
+    typedef typename RadixKey<Type>::Key Key;
+    const int digitNum = sizeof(Key) * 8 / RADIX_BITS;
+    Key* keyBuffer = new(std::nothrow) Key[2 * static_cast<size_t>(n)];
+    unsigned int* rowBuffer = new(std::nothrow) unsigned int[n];
+    if (keyBuffer == NULL || rowBuffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * (2 * sizeof(Key) + sizeof(unsigned int)));
+    unsigned int count[sizeof(Key)][RADIX_BUCKETS] = { { 0 } };
+    for (int i = 0; i < n; i++) {
+        Key key = keyBuffer[i] = RadixKey<Type>::encode(keys[i]);
+        perm[i] = static_cast<unsigned int>(i);
+        for (int d = 0; d < digitNum; d++)
+            count[d][radixDigit(key, d)]++;
+    }
+    Key* srcKey = keyBuffer, * dstKey = keyBuffer + n;
+    unsigned int* srcRow = perm, * dstRow = rowBuffer;
+    for (int d = 0; d < digitNum; d++) {
+        unsigned int* bucket = count[d];
+        if (n == 0 || bucket[radixDigit(keyBuffer[0], d)] == static_cast<unsigned int>(n))
+            continue;
+        unsigned int offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            unsigned int size = bucket[b];
+            bucket[b] = offset;
+            offset += size;
+        }
+        for (int i = 0; i < n; i++) {
+            unsigned int position = bucket[radixDigit(srcKey[i], d)]++;
+            dstKey[position] = srcKey[i];
+            dstRow[position] = srcRow[i];
+        }
+        ins.moved(2 * static_cast<unsigned long long>(n));
+        std::swap(srcKey, dstKey);
+        std::swap(srcRow, dstRow);
+    }
+    if (srcRow != perm) {
+        std::copy(srcRow, srcRow + n, perm);
+        ins.moved(n);
+    }
+    delete[] rowBuffer;
+    delete[] keyBuffer;
+}
+
+/*
+ * Function Name:    mergeKeyRows
+ * Function:         Stable merge of the key/row runs [low, mid) and [mid, high) into dst
+ * Input Parameters: const Type srcKey[]
+ *                   const unsigned int srcRow[]
+ *                   int low
+ *                   int mid
+ *                   int high
+ *                   Type dstKey[]
+ *                   unsigned int dstRow[]
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void mergeKeyRows(const Type srcKey[], const unsigned int srcRow[], int low, int mid, int high, Type dstKey[], unsigned int dstRow[], Instrument& ins)
+{
+    int i = low, j = mid, k = low;
+    while (i < mid && j < high) {
+        bool takeB = ins.compare(srcKey[j] < srcKey[i]);
+        int from = takeB ? j : i;
+        dstKey[k] = srcKey[from];
+        dstRow[k++] = srcRow[from];
+        j += takeB;
+        i += !takeB;
+    }
+    for (; i < mid; i++, k++) {
+        dstKey[k] = srcKey[i];
+        dstRow[k] = srcRow[i];
+    }
+    for (; j < high; j++, k++) {
+        dstKey[k] = srcKey[j];
+        dstRow[k] = srcRow[j];
+    }
+    ins.moved(2 * static_cast<unsigned long long>(high - low));
+}
+
+/*
+ * Function Name:    mergeArgsort
+ * Function:         Get the stable permutation that sorts keys with a bottom-up merge sort
+ * Input Parameters: const Type keys[]
+ *                   unsigned int perm[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The comparison-based counterpart of radixArgsort for keys without a RadixKey. Comparisons read
+ *                   the key copies next to the row ids instead of keys[perm[i]], so every access stays sequential
+ */
+template <typename Type, typename Instrument>
+void mergeArgsort(const Type keys[], unsigned int perm[], int n, Instrument& ins)
+{
+    Type* keyBuffer = new(std::nothrow) Type[2 * static_cast<size_t>(n)];
+    unsigned int* rowBuffer = new(std::nothrow) unsigned int[n];
+    if (keyBuffer == NULL || rowBuffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * (2 * sizeof(Type) + sizeof(unsigned int)));
+    for (int start = 0; start < n; start += MERGE_RUN_LENGTH) {
+        int end = std::min(start + MERGE_RUN_LENGTH, n);
+        for (int i = start; i < end; i++) {
+            Type key = keys[i];
+            int j = i - 1;
+            for (; j >= start && ins.compare(key < keyBuffer[j]); j--) {
+                keyBuffer[j + 1] = keyBuffer[j];
+                perm[j + 1] = perm[j];
+            }
+            keyBuffer[j + 1] = key;
+            perm[j + 1] = static_cast<unsigned int>(i);
+            ins.moved(2 * (i - j));
+        }
+    }
+    Type* srcKey = keyBuffer, * dstKey = keyBuffer + n;
+    unsigned int* srcRow = perm, * dstRow = rowBuffer;
+    for (long long width = MERGE_RUN_LENGTH; width < n; width *= 2) {
+        for (long long low = 0; low < n; low += 2 * width)
+            mergeKeyRows(srcKey, srcRow, static_cast<int>(low), static_cast<int>(std::min(low + width, static_cast<long long>(n))),
+                static_cast<int>(std::min(low + 2 * width, static_cast<long long>(n))), dstKey, dstRow, ins);
+        std::swap(srcKey, dstKey);
+        std::swap(srcRow, dstRow);
+    }
+    if (srcRow != perm) {
+        std::copy(srcRow, srcRow + n, perm);
+        ins.moved(n);
+    }
+    delete[] rowBuffer;
+    delete[] keyBuffer;
+}
+
+/*
+ * Function Name:    permuteKeyValue
+ * Function:         Reorder keys and values so that position i receives the row perm[i]
+ * Input Parameters: Type keys[]
+ *                   Payload values[]
+ *                   unsigned int perm[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The permutation is applied in place cycle by cycle, so every key and payload is moved exactly
+ *                   once and no payload-sized buffer is needed. perm is consumed, every entry ends as its index
+ */
+template <typename Type, typename Payload, typename Instrument>
+void permuteKeyValue(Type keys[], Payload values[], unsigned int perm[], int n, Instrument& ins)
+{
+    for (int i = 0; i < n; i++) {
+        if (perm[i] == static_cast<unsigned int>(i))
+            continue;
+        Type key = keys[i];
+        Payload value = values[i];
+        int j = i;
+        while (perm[j] != static_cast<unsigned int>(i)) {
+            int next = static_cast<int>(perm[j]);
+            keys[j] = keys[next];
+            values[j] = values[next];
+            perm[j] = static_cast<unsigned int>(j);
+            j = next;
+            ins.moved(2);
+        }
+        keys[j] = key;
+        values[j] = value;
+        perm[j] = static_cast<unsigned int>(j);
+        ins.moved(2);
+    }
+}
+
+/*
+ * Function Name:    keyValueSort
+ * Function:         Sort keys and reorder the payload column values with them
+ * Input Parameters: Type keys[]
+ *                   Payload values[]
+ *                   int n
+ *                   bool radix
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Stable. The argsort never touches the payload, which is moved once by permuteKeyValue
+ */
+template <typename Type, typename Payload, typename Instrument>
+void keyValueSort(Type keys[], Payload values[], int n, bool radix, Instrument& ins)
+{
+    unsigned int* perm = new(std::nothrow) unsigned int[n];
+    if (perm == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(unsigned int));
+    if (radix)
+        radixArgsort(keys, perm, n, ins);
+    else
+        mergeArgsort(keys, perm, n, ins);
+    permuteKeyValue(keys, values, perm, n, ins);
+    delete[] perm;
+}
+
+/*
+ * Function Name:    keyValueRows
+ * Function:         Sort arr as a key column with the row ids 0..n-1 as its payload column
+ * Input Parameters: Type arr[]
+ *                   unsigned int rowIds[]
+ *                   int n
+ *                   bool radix
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueRows(Type arr[], unsigned int rowIds[], int n, bool radix, Instrument& ins)
+{
+    for (int i = 0; i < n; i++)
+        rowIds[i] = static_cast<unsigned int>(i);
+    keyValueSort(arr, rowIds, n, radix, ins);
+}
+
+/*
+ * Function Name:    keyValueBenchmark
+ * Function:         Sort arr as a key column with a temporary column of 32-bit row ids as its payload
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   bool radix
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueBenchmark(Type arr[], int n, bool radix, Instrument& ins)
+{
+    unsigned int* rowIds = new(std::nothrow) unsigned int[n];
+    if (rowIds == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(n) * sizeof(unsigned int));
+    keyValueRows(arr, rowIds, n, radix, ins);
+    delete[] rowIds;
+}
+
+/*
+ * Function Name:    keyValueRadixSort
+ * Function:         Key/row id sort through radixArgsort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueRadixSort(Type arr[], int n, Instrument& ins)
+{
+    keyValueBenchmark(arr, n, true, ins);
+}
+
+/*
+ * Function Name:    keyValueMergeSort
+ * Function:         Key/row id sort through mergeArgsort
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueMergeSort(Type arr[], int n, Instrument& ins)
+{
+    keyValueBenchmark(arr, n, false, ins);
+}
+
+/*
+ * Function Name:    keyValueRadixRows
+ * Function:         Key/row id sort through radixArgsort into a caller-owned row id column
+ * Input Parameters: Type arr[]
+ *                   unsigned int rowIds[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueRadixRows(Type arr[], unsigned int rowIds[], int n, Instrument& ins)
+{
+    keyValueRows(arr, rowIds, n, true, ins);
+}
+
+/*
+ * Function Name:    keyValueMergeRows
+ * Function:         Key/row id sort through mergeArgsort into a caller-owned row id column
+ * Input Parameters: Type arr[]
+ *                   unsigned int rowIds[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void keyValueMergeRows(Type arr[], unsigned int rowIds[], int n, Instrument& ins)
+{
+    keyValueRows(arr, rowIds, n, false, ins);
+}
+
+#ifdef SIMD_SORT_AVAILABLE
+/*
+ * Function Name:    cpuSupportsAvx2
+ * Function:         Check whether the CPU and the operating system support AVX2
+ * Input Parameters: void
+ * Return Value:     true / false
+ */
+bool cpuSupportsAvx2(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+/* Define static partition tables, indexed by the mask of lanes that go right */
+static int partitionPermTable[256][8];
+static int partitionRightNum[256];
+
+/*
+ * Function Name:    initPartitionTables
+ * Function:         Build the permutations that move left lanes to the front and right lanes to the back
+ * Input Parameters: void
+ * Return Value:     true
+ */
+bool initPartitionTables(void)
+{
+    for (int mask = 0; mask < 256; mask++) {
+        int k = 0;
+        for (int i = 0; i < 8; i++)
+            if (!(mask & (1 << i)))
+                partitionPermTable[mask][k++] = i;
+        partitionRightNum[mask] = 8 - k;
+        for (int i = 0; i < 8; i++)
+            if (mask & (1 << i))
+                partitionPermTable[mask][k++] = i;
+    }
+    return true;
+}
+
+/*
+ * Function Name:    sortStep8
+ * Function:         Compare-exchange every lane with the lane given by perm, lanes in BlendMask keep the maximum
+ * Input Parameters: __m256i v
+ *                   __m256i perm
+ *                   Instrument& ins
+ * Return Value:     the vector after the step
+ */
+template <int BlendMask, typename Instrument>
+AVX2_TARGET inline __m256i sortStep8(__m256i v, __m256i perm, Instrument& ins)
+{
+    __m256i p = _mm256_permutevar8x32_epi32(v, perm);
+    ins.compared(8);
+    return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), BlendMask);
+}
+
+/*
+ * Function Name:    bitonicClean8
+ * Function:         Sort a bitonic vector of 8 lanes
+ * Input Parameters: __m256i v
+ *                   Instrument& ins
+ * Return Value:     the sorted vector
+ */
+template <typename Instrument>
+AVX2_TARGET inline __m256i bitonicClean8(__m256i v, Instrument& ins)
+{
+    v = sortStep8<0xF0>(v, _mm256_setr_epi32(4, 5, 6, 7, 0, 1, 2, 3), ins);
+    v = sortStep8<0xCC>(v, _mm256_setr_epi32(2, 3, 0, 1, 6, 7, 4, 5), ins);
+    return sortStep8<0xAA>(v, _mm256_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6), ins);
+}
+
+/*
+ * Function Name:    sort8
+ * Function:         Bitonic sorting network on the 8 lanes of a vector
+ * Input Parameters: __m256i v
+ *                   Instrument& ins
+ * Return Value:     the sorted vector
+ */
+template <typename Instrument>
+AVX2_TARGET inline __m256i sort8(__m256i v, Instrument& ins)
+{
+    v = sortStep8<0x66>(v, _mm256_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6), ins);
+    v = sortStep8<0x3C>(v, _mm256_setr_epi32(2, 3, 0, 1, 6, 7, 4, 5), ins);
+    v = sortStep8<0x5A>(v, _mm256_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6), ins);
+    return bitonicClean8(v, ins);
+}
+
+/*
+ * Function Name:    bitonicCleanVectors
+ * Function:         Sort a bitonic sequence stored in count vectors
+ * Input Parameters: __m256i v[]
+ *                   int count
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Instrument>
+AVX2_TARGET inline void bitonicCleanVectors(__m256i v[], int count, Instrument& ins)
+{
+    for (int dist = count / 2; dist > 0; dist /= 2)
+        for (int i = 0; i < count; i++)
+            if (!(i & dist)) {
+                __m256i low = _mm256_min_epi32(v[i], v[i + dist]);
+                v[i + dist] = _mm256_max_epi32(v[i], v[i + dist]);
+                v[i] = low;
+                ins.compared(8);
+            }
+    for (int i = 0; i < count; i++)
+        v[i] = bitonicClean8(v[i], ins);
+}
+
+/*
+ * Function Name:    mergeVectors
+ * Function:         In-register bitonic merge of two sorted sequences of count vectors each
+ * Input Parameters: __m256i a[]
+ *                   __m256i b[]
+ *                   int count
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Afterwards a holds the smaller half and b the larger half, both sorted
+ */
+template <typename Instrument>
+AVX2_TARGET inline void mergeVectors(__m256i a[], __m256i b[], int count, Instrument& ins)
+{
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i low[SIMD_BLOCK_SIZE / 8], high[SIMD_BLOCK_SIZE / 8];
+    for (int i = 0; i < count; i++) {
+        __m256i r = _mm256_permutevar8x32_epi32(b[count - 1 - i], reverse);
+        low[i] = _mm256_min_epi32(a[i], r);
+        high[i] = _mm256_max_epi32(a[i], r);
+        ins.compared(8);
+    }
+    bitonicCleanVectors(low, count, ins);
+    bitonicCleanVectors(high, count, ins);
+    for (int i = 0; i < count; i++) {
+        a[i] = low[i];
+        b[i] = high[i];
+    }
+}
+
+/*
+ * Function Name:    sortBlockAvx2
+ * Function:         Sort at most 64 elements with the 8/16/32/64-element sorting networks
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The block is padded with INT_MAX up to a power of two vectors
+ */
+template <typename Instrument>
+AVX2_TARGET void sortBlockAvx2(int arr[], int n, Instrument& ins)
+{
+    int count = 1;
+    while (count * 8 < n)
+        count *= 2;
+    int block[SIMD_BLOCK_SIZE];
+    __m256i v[SIMD_BLOCK_SIZE / 8];
+    std::copy(arr, arr + n, block);
+    std::fill(block + n, block + count * 8, INT_MAX);
+    for (int i = 0; i < count; i++)
+        v[i] = sort8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 8)), ins);
+    for (int width = 1; width < count; width *= 2)
+        for (int i = 0; i < count; i += 2 * width)
+            mergeVectors(v + i, v + i + width, width, ins);
+    for (int i = 0; i < count; i++)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i * 8), v[i]);
+    std::copy(block, block + n, arr);
+    ins.moved(2 * n);
+}
+
+/*
+ * Function Name:    partitionMask
+ * Function:         Get the mask of the lanes that belong to the right part
+ * Input Parameters: __m256i v
+ *                   __m256i pivot
+ *                   bool strict
+ *                   Instrument& ins
+ * Return Value:     the lane mask
+ * Notes:            Lanes greater than the pivot go right, or lanes not less than the pivot when strict
+ */
+template <typename Instrument>
+AVX2_TARGET inline int partitionMask(__m256i v, __m256i pivot, bool strict, Instrument& ins)
+{
+    ins.compared(8);
+    if (strict)
+        return ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pivot, v))) & 0xFF;
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pivot)));
+}
+
+/*
+ * Function Name:    partitionAvx2
+ * Function:         In-place vectorized partition around a pivot value
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   int pivot
+ *                   bool strict
+ *                   Instrument& ins
+ * Return Value:     the size of the left part
+ * Notes:            n >= 16. The first and last vectors are held in registers, every other vector is read from
+ *                   the side with less free space and compressed to both ends through partitionPermTable
+ */
+template <typename Instrument>
+AVX2_TARGET int partitionAvx2(int arr[], int n, int pivot, bool strict, Instrument& ins)
+{
+    __m256i pivotVec = _mm256_set1_epi32(pivot);
+    __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr));
+    __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr + n - 8));
+    int readLeft = 8, readRight = n - 8, writeLeft = 0, writeRight = n;
+    while (readRight - readLeft >= 8) {
+        __m256i v;
+        if (readLeft - writeLeft <= writeRight - readRight) {
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr + readLeft));
+            readLeft += 8;
+        }
+        else {
+            readRight -= 8;
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr + readRight));
+        }
+        int mask = partitionMask(v, pivotVec, strict, ins);
+        v = _mm256_permutevar8x32_epi32(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(partitionPermTable[mask])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(arr + writeLeft), v);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(arr + writeRight - 8), v);
+        writeLeft += 8 - partitionRightNum[mask];
+        writeRight -= partitionRightNum[mask];
+    }
+    int rest[8], restNum = readRight - readLeft;
+    std::copy(arr + readLeft, arr + readRight, rest);
+    for (int i = 0; i < restNum; i++) {
+        if (ins.compare(strict ? !(rest[i] < pivot) : rest[i] > pivot))
+            arr[--writeRight] = rest[i];
+        else
+            arr[writeLeft++] = rest[i];
+    }
+    int mask = partitionMask(first, pivotVec, strict, ins);
+    first = _mm256_permutevar8x32_epi32(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(partitionPermTable[mask])));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(arr + writeLeft), first);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(arr + writeRight - 8), first);
+    writeLeft += 8 - partitionRightNum[mask];
+    mask = partitionMask(last, pivotVec, strict, ins);
+    last = _mm256_permutevar8x32_epi32(last, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(partitionPermTable[mask])));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(arr + writeLeft), last);
+    ins.moved(n);
+    return writeLeft + 8 - partitionRightNum[mask];
+}
+
+/*
+ * Function Name:    simdQuickSortAvx2
+ * Function:         Quick sort with the vectorized partition and sorting network leaves
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   int depthLimit
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The pivot is a ninther. When every element is not greater than the pivot,
+ *                   a strict partition splits off the run equal to it
+ */
+template <typename Instrument>
+AVX2_TARGET void simdQuickSortAvx2(int arr[], int n, int depthLimit, Instrument& ins)
+{
+    DepthGuard<Instrument> guard(ins);
+    while (n > SIMD_BLOCK_SIZE) {
+        if (depthLimit-- == 0) {
+            heapSort(arr, n, ins);
+            return;
+        }
+        int step = n / 8, pivot = arr[medianOfThree(arr,
+            medianOfThree(arr, 0, step, 2 * step, ins),
+            medianOfThree(arr, n / 2 - step, n / 2, n / 2 + step, ins),
+            medianOfThree(arr, n - 1 - 2 * step, n - 1 - step, n - 1, ins), ins)];
+        int mid = partitionAvx2(arr, n, pivot, false, ins);
+        if (mid == n) {
+            n = partitionAvx2(arr, n, pivot, true, ins);
+            continue;
+        }
+        if (mid < n - mid) {
+            simdQuickSortAvx2(arr, mid, depthLimit, ins);
+            arr += mid;
+            n -= mid;
+        }
+        else {
+            simdQuickSortAvx2(arr + mid, n - mid, depthLimit, ins);
+            n = mid;
+        }
+    }
+    sortBlockAvx2(arr, n, ins);
+}
+
+/*
+ * Function Name:    mergeAvx2
+ * Function:         Merge two sorted runs whose lengths are multiples of 8 with the in-register bitonic merge
+ * Input Parameters: const int a[]
+ *                   int na
+ *                   const int b[]
+ *                   int nb
+ *                   int out[]
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Instrument>
+AVX2_TARGET void mergeAvx2(const int a[], int na, const int b[], int nb, int out[], Instrument& ins)
+{
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    int i = 8, j = 8, k = 0;
+    while (true) {
+        mergeVectors(&low, &high, 1, ins);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), low);
+        k += 8;
+        if (i < na && (j >= nb || ins.compare(a[i] <= b[j]))) {
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            i += 8;
+        }
+        else if (j < nb) {
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+            j += 8;
+        }
+        else
+            break;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), high);
+    ins.moved(na + nb);
+}
+
+/*
+ * Function Name:    simdMergeSortAvx2
+ * Function:         Bottom-up merge sort over 64-element network-sorted blocks
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            The data is copied into a buffer padded with INT_MAX to a multiple of 64
+ */
+template <typename Instrument>
+AVX2_TARGET void simdMergeSortAvx2(int arr[], int n, Instrument& ins)
+{
+    int m = (n + SIMD_BLOCK_SIZE - 1) / SIMD_BLOCK_SIZE * SIMD_BLOCK_SIZE;
+    int* src = new(std::nothrow) int[m];
+    int* dst = new(std::nothrow) int[m];
+    if (src == NULL || dst == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(2 * static_cast<unsigned long long>(m) * sizeof(int));
+    std::copy(arr, arr + n, src);
+    std::fill(src + n, src + m, INT_MAX);
+    ins.moved(n);
+    for (int i = 0; i < m; i += SIMD_BLOCK_SIZE)
+        sortBlockAvx2(src + i, SIMD_BLOCK_SIZE, ins);
+    for (int width = SIMD_BLOCK_SIZE; width < m; width *= 2) {
+        for (int start = 0; start < m; start += 2 * width) {
+            if (start + width >= m) {
+                std::copy(src + start, src + m, dst + start);
+                ins.moved(m - start);
+            }
+            else
+                mergeAvx2(src + start, width, src + start + width, std::min(width, m - start - width), dst + start, ins);
+        }
+        std::swap(src, dst);
+    }
+    std::copy(src, src + n, arr);
+    ins.moved(n);
+    delete[] src;
+    delete[] dst;
+}
+#endif
+
+/*
+ * Function Name:    simdQuickSort
+ * Function:         SIMD quick sort
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Falls back to intro sort when AVX2 is not available
+ */
+template <typename Instrument>
+void simdQuickSort(int arr[], int n, Instrument& ins)
+{
+#ifdef SIMD_SORT_AVAILABLE
+    static const bool avx2 = cpuSupportsAvx2() && initPartitionTables();
+    if (avx2) {
+        int depthLimit = 0;
+        for (int i = n; i > 1; i >>= 1)
+            depthLimit += 2;
+        simdQuickSortAvx2(arr, n, depthLimit, ins);
+        return;
+    }
+#endif
+    introSort(arr, n, ins);
+}
+
+/*
+ * Function Name:    simdMergeSort
+ * Function:         SIMD merge sort
+ * Input Parameters: int arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Falls back to merge sort when AVX2 is not available
+ */
+template <typename Instrument>
+void simdMergeSort(int arr[], int n, Instrument& ins)
+{
+#ifdef SIMD_SORT_AVAILABLE
+    static const bool avx2 = cpuSupportsAvx2();
+    if (avx2) {
+        simdMergeSortAvx2(arr, n, ins);
+        return;
+    }
+#endif
+    mergeSort(arr, n, ins);
+}
+
+/* Define IdentityProjection structure */
+struct IdentityProjection {
+    template <typename Type>
+    const Type& operator()(const Type& value) const { return value; }
+};
+
+/* Define DefaultLess structure */
+struct DefaultLess {
+    template <typename Type>
+    bool operator()(const Type& a, const Type& b) const { return a < b; }
+};
+
+/* Define FirstProjection structure */
+struct FirstProjection {
+    template <typename Pair>
+    const typename Pair::first_type& operator()(const Pair& pair) const { return pair.first; }
+};
+
+/* Define FixedString structure */
+struct FixedString {
+    char data[FIXED_STRING_LENGTH];
+};
+
+/* Define FixedStringLess structure */
+struct FixedStringLess {
+    bool operator()(const FixedString& a, const FixedString& b) const { return memcmp(a.data, b.data, FIXED_STRING_LENGTH) < 0; }
+};
+
+/* Define FixedString order for the algorithms that use operator< directly */
+inline bool operator<(const FixedString& a, const FixedString& b)
+{
+    return FixedStringLess()(a, b);
+}
+
+inline bool operator>(const FixedString& a, const FixedString& b)
+{
+    return FixedStringLess()(b, a);
+}
+
+/* Define KeyIndexPair type */
+typedef std::pair<long long, int> KeyIndexPair;
+
+/* Define ProjectedLess structure template */
+template <typename Compare, typename Projection, typename Instrument>
+struct ProjectedLess {
+    Compare comp;
+    Projection proj;
+    Instrument* ins;
+    ProjectedLess(Compare _comp, Projection _proj, Instrument& _ins) :comp(_comp), proj(_proj), ins(&_ins) {}
+    template <typename Type>
+    bool operator()(const Type& a, const Type& b) const { return ins->compare(comp(proj(a), proj(b))); }
+};
+
+/*
+ * Function Name:    genericInsertionSort
+ * Function:         Insertion sort over [first, last)
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Less less
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Less, typename Instrument>
+void genericInsertionSort(RandomIt first, RandomIt last, Less less, Instrument& ins)
+{
+    if (first == last)
+        return;
+    for (RandomIt i = first + 1; i < last; ++i) {
+        typename std::iterator_traits<RandomIt>::value_type key = std::move(*i);
+        RandomIt j = i;
+        for (; j > first && less(key, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+            ins.moved(1);
+        }
+        *j = std::move(key);
+        ins.moved(2);
+    }
+}
+
+/*
+ * Function Name:    genericSiftDown
+ * Function:         Sift first[i] down the max heap first[0..n)
+ * Input Parameters: RandomIt first
+ *                   int n
+ *                   int i
+ *                   Less less
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Less, typename Instrument>
+void genericSiftDown(RandomIt first, int n, int i, Less less, Instrument& ins)
+{
+    typename std::iterator_traits<RandomIt>::value_type value = std::move(first[i]);
+    while (2 * i + 1 < n) {
+        int child = 2 * i + 1;
+        if (child + 1 < n && less(first[child], first[child + 1]))
+            child++;
+        if (!less(value, first[child]))
+            break;
+        first[i] = std::move(first[child]);
+        ins.moved(1);
+        i = child;
+    }
+    first[i] = std::move(value);
+    ins.moved(2);
+}
+
+/*
+ * Function Name:    genericHeapSort
+ * Function:         Heap sort over [first, last)
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Less less
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Less, typename Instrument>
+void genericHeapSort(RandomIt first, RandomIt last, Less less, Instrument& ins)
+{
+    int n = static_cast<int>(last - first);
+    for (int i = n / 2 - 1; i >= 0; i--)
+        genericSiftDown(first, n, i, less, ins);
+    for (int i = n - 1; i > 0; i--) {
+        std::iter_swap(first, first + i);
+        ins.moved(3);
+        genericSiftDown(first, i, 0, less, ins);
+    }
+}
+
+/*
+ * Function Name:    genericMedianOfThree
+ * Function:         Find the median of three elements
+ * Input Parameters: RandomIt a
+ *                   RandomIt b
+ *                   RandomIt c
+ *                   Less less
+ * Return Value:     the iterator of the median element
+ */
+template <typename RandomIt, typename Less>
+RandomIt genericMedianOfThree(RandomIt a, RandomIt b, RandomIt c, Less less)
+{
+    if (less(*a, *b))
+        return less(*b, *c) ? b : (less(*a, *c) ? c : a);
+    return less(*a, *c) ? a : (less(*b, *c) ? c : b);
+}
+
+/*
+ * Function Name:    genericIntroSortLoop
+ * Function:         Partition [first, last) until the ranges are small or too deep
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   int depthLimit
+ *                   Less less
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Same scheme as introSortLoop: median pivot at *first, unguarded Hoare partition
+ */
+template <typename RandomIt, typename Less, typename Instrument>
+void genericIntroSortLoop(RandomIt first, RandomIt last, int depthLimit, Less less, Instrument& ins)
+{
+    DepthGuard<Instrument> guard(ins);
+    while (last - first > INTRO_SORT_THRESHOLD) {
+        if (depthLimit-- == 0) {
+            genericHeapSort(first, last, less, ins);
+            return;
+        }
+        int n = static_cast<int>(last - first), step = n / 8;
+        RandomIt mid = first + n / 2, pivot;
+        if (n > NINTHER_THRESHOLD)
+            pivot = genericMedianOfThree(
+                genericMedianOfThree(first + 1, first + 1 + step, first + 1 + 2 * step, less),
+                genericMedianOfThree(mid - step, mid, mid + step, less),
+                genericMedianOfThree(last - 1 - 2 * step, last - 1 - step, last - 1, less), less);
+        else
+            pivot = genericMedianOfThree(first + 1, mid, last - 1, less);
+        std::iter_swap(first, pivot);
+        ins.moved(3);
+        RandomIt i = first + 1, j = last;
+        while (true) {
+            while (less(*i, *first))
+                ++i;
+            --j;
+            while (less(*first, *j))
+                --j;
+            if (!(i < j))
+                break;
+            std::iter_swap(i, j);
+            ins.moved(3);
+            ++i;
+        }
+        if (i - first < last - i) {
+            genericIntroSortLoop(first, i, depthLimit, less, ins);
+            first = i;
+        }
+        else {
+            genericIntroSortLoop(i, last, depthLimit, less, ins);
+            last = i;
+        }
+    }
+}
+
+/*
+ * Function Name:    genericIntroSort
+ * Function:         Intro sort over [first, last) ordered by comp on proj of the elements
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Compare comp
+ *                   Projection proj
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            comp and proj are template parameters, so their calls are inlined
+ */
+template <typename RandomIt, typename Compare, typename Projection, typename Instrument>
+void genericIntroSort(RandomIt first, RandomIt last, Compare comp, Projection proj, Instrument& ins)
+{
+    ProjectedLess<Compare, Projection, Instrument> less(comp, proj, ins);
+    int depthLimit = 0;
+    for (long long i = last - first; i > 1; i >>= 1)
+        depthLimit += 2;
+    genericIntroSortLoop(first, last, depthLimit, less, ins);
+    genericInsertionSort(first, last, less, ins);
+}
+
+/*
+ * Function Name:    genericIntroSort
+ * Function:         Intro sort over [first, last) ordered by comp on proj of the elements
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Compare comp
+ *                   Projection proj
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Compare, typename Projection>
+void genericIntroSort(RandomIt first, RandomIt last, Compare comp, Projection proj)
+{
+    NullInstrument ins;
+    genericIntroSort(first, last, comp, proj, ins);
+}
+
+/*
+ * Function Name:    genericIntroSort
+ * Function:         Intro sort over [first, last) with operator<
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ * Return Value:     void
+ */
+template <typename RandomIt>
+void genericIntroSort(RandomIt first, RandomIt last)
+{
+    genericIntroSort(first, last, DefaultLess(), IdentityProjection());
+}
+
+/*
+ * Function Name:    genericMergeSort
+ * Function:         Sort [first, last) stably with the result in buffer when toBuffer is set
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Value* buffer
+ *                   bool toBuffer
+ *                   Less less
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Value, typename Less, typename Instrument>
+void genericMergeSort(RandomIt first, RandomIt last, Value* buffer, bool toBuffer, Less less, Instrument& ins)
+{
+    DepthGuard<Instrument> guard(ins);
+    int n = static_cast<int>(last - first);
+    if (n <= INTRO_SORT_THRESHOLD) {
+        genericInsertionSort(first, last, less, ins);
+        if (toBuffer) {
+            std::move(first, last, buffer);
+            ins.moved(n);
+        }
+        return;
+    }
+    int half = n / 2;
+    genericMergeSort(first, first + half, buffer, !toBuffer, less, ins);
+    genericMergeSort(first + half, last, buffer + half, !toBuffer, less, ins);
+    if (toBuffer) {
+        RandomIt i = first, mid = first + half, j = mid;
+        Value* out = buffer;
+        while (i < mid && j < last)
+            *out++ = less(*j, *i) ? std::move(*j++) : std::move(*i++);
+        out = std::move(i, mid, out);
+        std::move(j, last, out);
+    }
+    else {
+        Value* i = buffer, * mid = buffer + half, * j = mid, * end = buffer + n;
+        RandomIt out = first;
+        while (i < mid && j < end)
+            *out++ = less(*j, *i) ? std::move(*j++) : std::move(*i++);
+        out = std::move(i, mid, out);
+        std::move(j, end, out);
+    }
+    ins.moved(n);
+}
+
+/*
+ * Function Name:    genericMergeSort
+ * Function:         Stable merge sort over [first, last) ordered by comp on proj of the elements
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Compare comp
+ *                   Projection proj
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            One buffer of n elements is allocated, the recursion levels alternate between it and the input
+ */
+template <typename RandomIt, typename Compare, typename Projection, typename Instrument>
+void genericMergeSort(RandomIt first, RandomIt last, Compare comp, Projection proj, Instrument& ins)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type Value;
+    Value* buffer = new(std::nothrow) Value[last - first];
+    if (buffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    ins.allocated(static_cast<unsigned long long>(last - first) * sizeof(Value));
+    genericMergeSort(first, last, buffer, false, ProjectedLess<Compare, Projection, Instrument>(comp, proj, ins), ins);
+    delete[] buffer;
+}
+
+/*
+ * Function Name:    genericMergeSort
+ * Function:         Stable merge sort over [first, last) ordered by comp on proj of the elements
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ *                   Compare comp
+ *                   Projection proj
+ * Return Value:     void
+ */
+template <typename RandomIt, typename Compare, typename Projection>
+void genericMergeSort(RandomIt first, RandomIt last, Compare comp, Projection proj)
+{
+    NullInstrument ins;
+    genericMergeSort(first, last, comp, proj, ins);
+}
+
+/*
+ * Function Name:    genericMergeSort
+ * Function:         Stable merge sort over [first, last) with operator<
+ * Input Parameters: RandomIt first
+ *                   RandomIt last
+ * Return Value:     void
+ */
+template <typename RandomIt>
+void genericMergeSort(RandomIt first, RandomIt last)
+{
+    genericMergeSort(first, last, DefaultLess(), IdentityProjection());
+}
+
+/* Define DefaultOrder structure template */
+template <typename Type>
+struct DefaultOrder {
+    typedef DefaultLess Compare;
+    typedef IdentityProjection Projection;
+};
+
+/* Define DefaultOrder structure for KeyIndexPair, ordered by key only */
+template <>
+struct DefaultOrder<KeyIndexPair> {
+    typedef DefaultLess Compare;
+    typedef FirstProjection Projection;
+};
+
+/* Define DefaultOrder structure for FixedString */
+template <>
+struct DefaultOrder<FixedString> {
+    typedef FixedStringLess Compare;
+    typedef IdentityProjection Projection;
+};
+
+/*
+ * Function Name:    genericIntroSortArray
+ * Function:         Generic intro sort of an array in the default order of Type
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void genericIntroSortArray(Type arr[], int n, Instrument& ins)
+{
+    genericIntroSort(arr, arr + n, typename DefaultOrder<Type>::Compare(), typename DefaultOrder<Type>::Projection(), ins);
+}
+
+/*
+ * Function Name:    genericMergeSortArray
+ * Function:         Generic merge sort of an array in the default order of Type
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void genericMergeSortArray(Type arr[], int n, Instrument& ins)
+{
+    genericMergeSort(arr, arr + n, typename DefaultOrder<Type>::Compare(), typename DefaultOrder<Type>::Projection(), ins);
+}
+
+/*
+ * Function Name:    genericHeapSortArray
+ * Function:         Generic heap sort of an array in the default order of Type
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ */
+template <typename Type, typename Instrument>
+void genericHeapSortArray(Type arr[], int n, Instrument& ins)
+{
+    typedef ProjectedLess<typename DefaultOrder<Type>::Compare, typename DefaultOrder<Type>::Projection, Instrument> Less;
+    genericHeapSort(arr, arr + n, Less(typename DefaultOrder<Type>::Compare(), typename DefaultOrder<Type>::Projection(), ins), ins);
+}
+
+/*
+ * Function Name:    stdSortArray
+ * Function:         std::sort of an array in the default order of Type, as a reference
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Instrument& ins
+ * Return Value:     void
+ * Notes:            Only the comparisons of std::sort are counted
+ */
+template <typename Type, typename Instrument>
+void stdSortArray(Type arr[], int n, Instrument& ins)
+{
+    typedef ProjectedLess<typename DefaultOrder<Type>::Compare, typename DefaultOrder<Type>::Projection, Instrument> Less;
+    std::sort(arr, arr + n, Less(typename DefaultOrder<Type>::Compare(), typename DefaultOrder<Type>::Projection(), ins));
+}
+
+/* Define GenericSortOptions structure template */
+template <typename Type>
+struct GenericSortOptions {
+    static const TypedSortOption<Type> options[GENERIC_SORT_OPTION_NUM];
+};
+
+/* Define GenericSortOptions array */
+template <typename Type>
+const TypedSortOption<Type> GenericSortOptions<Type>::options[GENERIC_SORT_OPTION_NUM] = {
+    { genericIntroSortArray, genericIntroSortArray, "generic-intro", "泛型内省排序 Generic Intro Sort", false },
+    { genericMergeSortArray, genericMergeSortArray, "generic-merge", "泛型归并排序 Generic Merge Sort", true },
+    { genericHeapSortArray, genericHeapSortArray, "generic-heap", "泛型堆排序 Generic Heap Sort", false },
+    { stdSortArray, stdSortArray, "std-sort", "标准库排序 std::sort", false }
+};
+
+/* Define SelectOptions structure template */
+template <typename Type>
+struct SelectOptions {
+    static const TypedSelectOption<Type> options[SELECT_OPTION_NUM];
+};
+
+/* Define SelectOptions array */
+template <typename Type>
+const TypedSelectOption<Type> SelectOptions<Type>::options[SELECT_OPTION_NUM] = {
+    { introSelect, introSelect, "introselect", "内省选择 Intro Select" },
+    { floydRivestSelect, floydRivestSelect, "floyd-rivest", "Floyd-Rivest选择 Floyd-Rivest Select" },
+    { heapSelect, heapSelect, "heap-select", "堆选择 Heap Top-K Select" }
+};
+
+/* Define sortOptions array */
+SortOption sortOptions[] = {
+    { bubbleSort, bubbleSort, "bubble", "冒泡排序 Bubble Sort", true },
+    { selectionSort, selectionSort, "selection", "选择排序 Selection Sort", false },
+    { insertionSort, insertionSort, "insertion", "插入排序 Insertion Sort", true },
+    { shellSort, shellSort, "shell", "希尔排序 Shell Sort", false },
+    { quickSort, quickSort, "quick", "快速排序 Quick Sort", false },
+    { heapSort, heapSort, "heap", "堆 排 序 Heap Sort", false },
+    { mergeSort, mergeSort, "merge", "归并排序 Merge Sort", true },
+    { radixSort, radixSort, "radix", "基数排序 Radix Sort", true },
+    { introSort, introSort, "intro", "内省排序 Intro Sort", false },
+    { parallelMergeSort, parallelMergeSort, "parallel-merge", "并行归并排序 Parallel Merge Sort", true },
+    { parallelQuickSort, parallelQuickSort, "parallel-quick", "并行快速排序 Parallel Quick Sort", false },
+    { lsdRadixSort, lsdRadixSort, "lsd-radix", "LSD基数排序 LSD Radix Sort", true },
+    { parallelRadixSort, parallelRadixSort, "parallel-radix", "并行基数排序 Parallel Radix Sort", true },
+    { simdQuickSort, simdQuickSort, "simd-quick", "SIMD快速排序 SIMD Quick Sort", false },
+    { simdMergeSort, simdMergeSort, "simd-merge", "SIMD归并排序 SIMD Merge Sort", false },
+    { genericIntroSortArray, genericIntroSortArray, "generic-intro", "泛型内省排序 Generic Intro Sort", false },
+    { genericMergeSortArray, genericMergeSortArray, "generic-merge", "泛型归并排序 Generic Merge Sort", true },
+    { bottomUpMergeSort, bottomUpMergeSort, "bottom-up-merge", "自底向上归并排序 Bottom-Up Merge Sort", true },
+    { fourWayMergeSort, fourWayMergeSort, "4way-merge", "四路归并排序 4-Way Merge Sort", true },
+    { timSort, timSort, "tim", "自适应归并排序 Tim Sort", true },
+    { ciuraShellSort, ciuraShellSort, "shell-ciura", "希尔排序 Ciura 增量 Shell Sort (Ciura)", false },
+    { tokudaShellSort, tokudaShellSort, "shell-tokuda", "希尔排序 Tokuda 增量 Shell Sort (Tokuda)", false },
+    { sedgewickShellSort, sedgewickShellSort, "shell-sedgewick", "希尔排序 Sedgewick 增量 Shell Sort (Sedgewick)", false },
+    { prattShellSort, prattShellSort, "shell-pratt", "希尔排序 Pratt 增量 Shell Sort (Pratt)", false },
+    { bottomUpHeapSort, bottomUpHeapSort, "bottom-up-heap", "自底向上堆排序 Bottom-Up Heap Sort", false },
+    { fourAryHeapSort, fourAryHeapSort, "4ary-heap", "四叉堆排序 4-Ary Heap Sort", false },
+    { eightAryHeapSort, eightAryHeapSort, "8ary-heap", "八叉堆排序 8-Ary Heap Sort", false },
+    { fourAryPrefetchHeapSort, fourAryPrefetchHeapSort, "4ary-heap-prefetch", "预取四叉堆排序 4-Ary Heap Sort (Prefetch)", false },
+    { eightAryPrefetchHeapSort, eightAryPrefetchHeapSort, "8ary-heap-prefetch", "预取八叉堆排序 8-Ary Heap Sort (Prefetch)", false },
+    { keyValueRadixSort, keyValueRadixSort, "kv-radix", "键值基数排序 Key-Value Radix Sort", true, keyValueRadixRows, keyValueRadixRows },
+    { keyValueMergeSort, keyValueMergeSort, "kv-merge", "键值归并排序 Key-Value Merge Sort", true, keyValueMergeRows, keyValueMergeRows }
+};
+
+/* Define the number of sort options */
+const int sortOptionNum = sizeof(sortOptions) / sizeof(sortOptions[0]);
+
+/* Define Xoshiro256 class */
+class Xoshiro256 {
+private:
+    unsigned long long state[4];
+    static unsigned long long rotl(unsigned long long x, int k) { return (x << k) | (x >> (64 - k)); }
+public:
+    Xoshiro256(unsigned long long seed);
+    unsigned long long next(void);
+    unsigned long long below(unsigned long long bound) { return next() % bound; }
+    double uniform(void) { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+/*
+ * Function Name:    Xoshiro256
+ * Function:         Seed the xoshiro256** generator through splitmix64
+ * Input Parameters: unsigned long long seed
+ * Notes:            Class external implementation of member functions
+ */
+Xoshiro256::Xoshiro256(unsigned long long seed)
+{
+    for (int i = 0; i < 4; i++) {
+        unsigned long long z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+/*
+ * Function Name:    next
+ * Function:         Generate the next 64-bit random number
+ * Input Parameters: void
+ * Return Value:     a 64-bit random number
+ * Notes:            Class external implementation of member functions
+ */
+unsigned long long Xoshiro256::next(void)
+{
+    unsigned long long result = rotl(state[1] * 5, 7) * 9, t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+/* Define GeneratorParams structure */
+struct GeneratorParams {
+    int swaps;
+    int uniqueKeys;
+    int teeth;
+    double zipfSkew;
+};
+
+/* Define default generator parameters */
+const GeneratorParams defaultGeneratorParams = { 10, 16, 16, 1.0 };
+
+/* Define GenerateFunction types */
+typedef void (*GenerateFunction)(int*, int, Xoshiro256&, const GeneratorParams&);
+typedef void (*GenerateFunction64)(long long*, int, Xoshiro256&, const GeneratorParams&);
+
+/* Define DistributionOption structure */
+struct DistributionOption {
+    GenerateFunction func;
+    GenerateFunction64 func64;
+    const char* name;
+    const char* description;
+};
+
+/*
+ * Function Name:    randomKey
+ * Function:         Generate a uniform random key over the non-negative range of Type
+ * Input Parameters: Xoshiro256& rng
+ * Return Value:     a random key
+ */
+template <typename Type>
+Type randomKey(Xoshiro256& rng)
+{
+    return static_cast<Type>(rng.next() & static_cast<unsigned long long>(std::numeric_limits<Type>::max()));
+}
+
+/*
+ * Function Name:    generateUniform
+ * Function:         Generate uniform random keys
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateUniform(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    (void)params;
+    for (int i = 0; i < n; i++)
+        arr[i] = randomKey<Type>(rng);
+}
+
+/*
+ * Function Name:    generateSorted
+ * Function:         Generate uniform random keys in ascending order
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateSorted(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    generateUniform(arr, n, rng, params);
+    std::sort(arr, arr + n);
+}
+
+/*
+ * Function Name:    generateReversed
+ * Function:         Generate uniform random keys in descending order
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateReversed(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    generateSorted(arr, n, rng, params);
+    std::reverse(arr, arr + n);
+}
+
+/*
+ * Function Name:    generateNearlySorted
+ * Function:         Generate sorted keys disturbed by params.swaps random swaps
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateNearlySorted(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    generateSorted(arr, n, rng, params);
+    for (int i = 0; n > 1 && i < params.swaps; i++) {
+        unsigned long long a = rng.below(n);
+        unsigned long long b = rng.below(n);
+        std::swap(arr[a], arr[b]);
+    }
+}
+
+/*
+ * Function Name:    generateFewUnique
+ * Function:         Generate keys drawn from params.uniqueKeys distinct values
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateFewUnique(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    Type* keys = new(std::nothrow) Type[params.uniqueKeys];
+    if (keys == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    for (int i = 0; i < params.uniqueKeys; i++)
+        keys[i] = randomKey<Type>(rng);
+    for (int i = 0; i < n; i++)
+        arr[i] = keys[rng.below(params.uniqueKeys)];
+    delete[] keys;
+}
+
+/*
+ * Function Name:    generateSawtooth
+ * Function:         Generate params.teeth ascending runs of equal length
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateSawtooth(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    (void)rng;
+    int period = std::max(1, n / params.teeth);
+    for (int i = 0; i < n; i++)
+        arr[i] = static_cast<Type>(i % period);
+}
+
+/*
+ * Function Name:    generateOrganPipe
+ * Function:         Generate keys ascending to the middle and descending afterwards
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ */
+template <typename Type>
+void generateOrganPipe(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    (void)rng;
+    (void)params;
+    for (int i = 0; i < n; i++)
+        arr[i] = static_cast<Type>(std::min(i, n - 1 - i));
+}
+
+/*
+ * Function Name:    generateZipf
+ * Function:         Generate Zipf distributed ranks with skew params.zipfSkew
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   Xoshiro256& rng
+ *                   const GeneratorParams& params
+ * Return Value:     void
+ * Notes:            Ranks are sampled by binary search over the cumulative distribution of at most 2^20 ranks
+ */
+template <typename Type>
+void generateZipf(Type arr[], int n, Xoshiro256& rng, const GeneratorParams& params)
+{
+    int rankNum = std::min(n, 1 << 20);
+    double* cdf = new(std::nothrow) double[rankNum];
+    if (cdf == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    double sum = 0;
+    for (int i = 0; i < rankNum; i++)
+        cdf[i] = (sum += 1.0 / pow(i + 1.0, params.zipfSkew));
+    for (int i = 0; i < n; i++) {
+        double* rank = std::lower_bound(cdf, cdf + rankNum, rng.uniform() * sum);
+        arr[i] = static_cast<Type>(std::min(static_cast<int>(rank - cdf), rankNum - 1));
+    }
+    delete[] cdf;
+}
+
+/* Define distributionOptions array */
+DistributionOption distributionOptions[] = {
+    { generateUniform, generateUniform, "uniform", "均匀随机 Uniform" },
+    { generateSorted, generateSorted, "sorted", "升序 Sorted" },
+    { generateReversed, generateReversed, "reversed", "降序 Reversed" },
+    { generateNearlySorted, generateNearlySorted, "nearly-sorted", "基本有序 Nearly Sorted" },
+    { generateFewUnique, generateFewUnique, "few-unique", "少量重复键 Few Unique" },
+    { generateSawtooth, generateSawtooth, "sawtooth", "锯齿 Sawtooth" },
+    { generateOrganPipe, generateOrganPipe, "organ-pipe", "管风琴 Organ Pipe" },
+    { generateZipf, generateZipf, "zipf", "齐夫分布 Zipf" }
+};
+
+/* Define the pseudo distribution of inputs loaded from a file */
+const DistributionOption fileDistribution = { NULL, NULL, "file", "文件输入 File Input" };
+
+/* Define the number of distribution options */
+const int distributionOptionNum = sizeof(distributionOptions) / sizeof(distributionOptions[0]);
+
+/*
+ * Function Name:    verifyMix
+ * Function:         Mix a 32-bit word for the multiset hash
+ * Input Parameters: unsigned int x
+ * Return Value:     the mixed word
+ * Notes:            The MurmurHash3 finalizer, a bijection, so replacing one element always changes the hash
+ */
+inline unsigned int verifyMix(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+/*
+ * Function Name:    verifyMix64
+ * Function:         Mix a 64-bit word for the multiset hash
+ * Input Parameters: unsigned long long x
+ * Return Value:     the mixed word
+ * Notes:            The SplitMix64 finalizer, also a bijection
+ */
+inline unsigned long long verifyMix64(unsigned long long x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/*
+ * Function Name:    verifyHash
+ * Function:         Hash one element for the multiset hash
+ * Input Parameters: const Type& value
+ * Return Value:     the element hash
+ * Notes:            Every byte of the value is hashed, padding is skipped
+ */
+inline unsigned long long verifyHash(long long value)
+{
+    return verifyMix64(static_cast<unsigned long long>(value));
+}
+
+inline unsigned long long verifyHash(double value)
+{
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return verifyMix64(bits);
+}
+
+inline unsigned long long verifyHash(const KeyIndexPair& value)
+{
+    return verifyMix64(static_cast<unsigned long long>(value.first) ^ verifyMix64(static_cast<unsigned long long>(value.second) + 0x9e3779b97f4a7c15ULL));
+}
+
+inline unsigned long long verifyHash(const FixedString& value)
+{
+    unsigned long long words[FIXED_STRING_LENGTH / 8];
+    memcpy(words, value.data, sizeof(words));
+    unsigned long long hash = 0;
+    for (int i = 0; i < FIXED_STRING_LENGTH / 8; i++)
+        hash = verifyMix64(hash ^ words[i]);
+    return hash;
+}
+
+/*
+ * Function Name:    inputOrder
+ * Function:         Check that two elements with equal keys are in their input order
+ * Input Parameters: const Type& a
+ *                   const Type& b
+ * Return Value:     true if a may precede b in a stable sort
+ * Notes:            Only KeyIndexPair carries the input position of its key, other types cannot show instability
+ */
+template <typename Type>
+inline bool inputOrder(const Type& a, const Type& b)
+{
+    (void)a;
+    (void)b;
+    return true;
+}
+
+inline bool inputOrder(const KeyIndexPair& a, const KeyIndexPair& b)
+{
+    return a.second < b.second;
+}
+
+/*
+ * Function Name:    verifyPass
+ * Function:         Check the order of arr and hash it as a multiset in one pass
+ * Input Parameters: const Type arr[]
+ *                   int n
+ *                   VerifyResult& result
+ * Return Value:     the multiset hash of arr
+ * Notes:            The hash is a sum of element hashes, so it ignores the order. The order is the default order
+ *                   of Type, and equal keys must keep their input order
+ */
+template <typename Type>
+unsigned long long verifyPass(const Type arr[], int n, VerifyResult& result)
+{
+    typename DefaultOrder<Type>::Compare comp;
+    typename DefaultOrder<Type>::Projection proj;
+    unsigned long long hash = n > 0 ? verifyHash(arr[0]) : 0;
+    bool ordered = true, stable = true;
+    for (int i = 1; i < n; i++) {
+        bool descent = comp(proj(arr[i]), proj(arr[i - 1]));
+        ordered = ordered && !descent;
+        stable = stable && (descent || comp(proj(arr[i - 1]), proj(arr[i])) || inputOrder(arr[i - 1], arr[i]));
+        hash += verifyHash(arr[i]);
+    }
+    result.ordered = ordered;
+    result.stable = stable;
+    return hash;
+}
+
+/*
+ * Function Name:    verifyPassScalar
+ * Function:         Check the order of an int array and hash it as a multiset in one pass
+ * Input Parameters: const int arr[]
+ *                   int n
+ *                   VerifyResult& result
+ * Return Value:     the multiset hash of arr
+ * Notes:            Two 32-bit sums of differently seeded mixes form the hash, matching the lanes of verifyPassAvx2
+ */
+inline unsigned long long verifyPassScalar(const int arr[], int n, VerifyResult& result)
+{
+    unsigned int sumA = 0, sumB = 0;
+    bool unsorted = false;
+    for (int i = 0; i < n; i++) {
+        unsigned int x = static_cast<unsigned int>(arr[i]);
+        unsorted |= i + 1 < n && arr[i + 1] < arr[i];
+        sumA += verifyMix(x ^ VERIFY_SEED_A);
+        sumB += verifyMix(x ^ VERIFY_SEED_B);
+    }
+    result.ordered = !unsorted;
+    result.stable = true;
+    return static_cast<unsigned long long>(sumA) << 32 | sumB;
+}
+
+#ifdef SIMD_SORT_AVAILABLE
+/*
+ * Function Name:    verifyMixAvx2
+ * Function:         verifyMix on eight lanes
+ * Input Parameters: __m256i x
+ * Return Value:     the mixed lanes
+ */
+AVX2_TARGET inline __m256i verifyMixAvx2(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x85ebca6bu)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 13));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0xc2b2ae35u)));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+/*
+ * Function Name:    verifyPassAvx2
+ * Function:         verifyPassScalar on eight elements per step
+ * Input Parameters: const int arr[]
+ *                   int n
+ *                   VerifyResult& result
+ * Return Value:     the multiset hash of arr
+ * Notes:            Each element is compared with its successor through an unaligned load shifted by one
+ */
+AVX2_TARGET unsigned long long verifyPassAvx2(const int arr[], int n, VerifyResult& result)
+{
+    const __m256i seedA = _mm256_set1_epi32(static_cast<int>(VERIFY_SEED_A)), seedB = _mm256_set1_epi32(static_cast<int>(VERIFY_SEED_B));
+    __m256i unsorted = _mm256_setzero_si256(), sumA = _mm256_setzero_si256(), sumB = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 < n; i += 8) {
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr + i));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arr + i + 1));
+        unsorted = _mm256_or_si256(unsorted, _mm256_cmpgt_epi32(current, next));
+        sumA = _mm256_add_epi32(sumA, verifyMixAvx2(_mm256_xor_si256(current, seedA)));
+        sumB = _mm256_add_epi32(sumB, verifyMixAvx2(_mm256_xor_si256(current, seedB)));
+    }
+    unsigned int lanesA[8], lanesB[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesA), sumA);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesB), sumB);
+    VerifyResult tail;
+    unsigned long long tailHash = verifyPassScalar(arr + i, n - i, tail);
+    unsigned int hashA = static_cast<unsigned int>(tailHash >> 32), hashB = static_cast<unsigned int>(tailHash);
+    for (int lane = 0; lane < 8; lane++) {
+        hashA += lanesA[lane];
+        hashB += lanesB[lane];
+    }
+    result.ordered = _mm256_testz_si256(unsorted, unsorted) && tail.ordered;
+    result.stable = true;
+    return static_cast<unsigned long long>(hashA) << 32 | hashB;
+}
+#endif
+
+/*
+ * Function Name:    verifyPass
+ * Function:         Check the order of an int array and hash it as a multiset in one pass
+ * Input Parameters: const int arr[]
+ *                   int n
+ *                   VerifyResult& result
+ * Return Value:     the multiset hash of arr
+ * Notes:            Dispatches to AVX2 when the CPU supports it
+ */
+inline unsigned long long verifyPass(const int arr[], int n, VerifyResult& result)
+{
+#ifdef SIMD_SORT_AVAILABLE
+    static const bool avx2 = cpuSupportsAvx2();
+    if (avx2)
+        return verifyPassAvx2(arr, n, result);
+#endif
+    return verifyPassScalar(arr, n, result);
+}
+
+/*
+ * Function Name:    verifySorted
+ * Function:         Verify the output of a sort
+ * Input Parameters: const Type arr[]
+ *                   int n
+ *                   unsigned long long inputHash
+ *                   bool stable
+ * Return Value:     the verification result
+ */
+template <typename Type>
+VerifyResult verifySorted(const Type arr[], int n, unsigned long long inputHash, bool stable)
+{
+    VerifyResult result;
+    result.permutation = verifyPass(arr, n, result) == inputHash;
+    result.stable = result.stable || !stable;
+    return result;
+}
+
+/*
+ * Function Name:    verifyRowIds
+ * Function:         Verify the row id payload column of a key/value sort
+ * Input Parameters: const Type keys[]
+ *                   const unsigned int rowIds[]
+ *                   int n
+ *                   const Type input[]
+ * Return Value:     the verification result
+ * Notes:            permutation means that every key is still paired with its input row, stable that the row ids
+ *                   increase within every run of equal keys. Together with the multiset hash of the keys this also
+ *                   makes the row ids a permutation of 0..n-1
+ */
+template <typename Type>
+VerifyResult verifyRowIds(const Type keys[], const unsigned int rowIds[], int n, const Type input[])
+{
+    typename DefaultOrder<Type>::Compare comp;
+    typename DefaultOrder<Type>::Projection proj;
+    VerifyResult result;
+    bool paired = true, stable = true;
+    for (int i = 0; i < n; i++) {
+        unsigned int row = rowIds[i];
+        paired = paired && row < static_cast<unsigned int>(n) && !comp(proj(keys[i]), proj(input[row])) && !comp(proj(input[row]), proj(keys[i]));
+        if (i > 0 && !comp(proj(keys[i - 1]), proj(keys[i])))
+            stable = stable && rowIds[i - 1] < row;
+    }
+    result.permutation = paired;
+    result.stable = stable;
+    return result;
+}
+
+/*
+ * Function Name:    verifySelected
+ * Function:         Verify the output of a selection of the k-th smallest element
+ * Input Parameters: const Type arr[]
+ *                   int n
+ *                   int k
+ *                   unsigned long long inputHash
+ * Return Value:     the verification result
+ * Notes:            ordered means that no element before arr[k] is greater and none after it is smaller
+ */
+template <typename Type>
+VerifyResult verifySelected(const Type arr[], int n, int k, unsigned long long inputHash)
+{
+    typename DefaultOrder<Type>::Compare comp;
+    typename DefaultOrder<Type>::Projection proj;
+    VerifyResult result;
+    result.permutation = verifyPass(arr, n, result) == inputHash;
+    bool partitioned = true;
+    for (int i = 0; i < k; i++)
+        partitioned = partitioned && !comp(proj(arr[k]), proj(arr[i]));
+    for (int i = k + 1; i < n; i++)
+        partitioned = partitioned && !comp(proj(arr[i]), proj(arr[k]));
+    result.ordered = partitioned;
+    result.stable = true;
+    return result;
+}
+
+/* Define SortCall structure template, adapts a sort option to runCallBenchmark */
+template <typename Type>
+struct SortCall {
+    const TypedSortOption<Type>& option;
+    unsigned int* rowIds;
+    SortCall(const TypedSortOption<Type>& _option, int n);
+    ~SortCall() { delete[] rowIds; }
+    void operator()(Type arr[], int n, NullInstrument& ins) const;
+    void operator()(Type arr[], int n, CountingInstrument& ins) const;
+    VerifyResult verify(const Type arr[], int n, unsigned long long inputHash, const Type input[]) const;
+private:
+    SortCall(const SortCall&);
+    SortCall& operator=(const SortCall&);
+};
+
+/*
+ * Function Name:    SortCall
+ * Function:         Adapt a sort option, with a row id column for the key/value options
+ * Input Parameters: const TypedSortOption<Type>& _option
+ *                   int n
+ * Notes:            Class external implementation of member functions
+ *                   The row id column outlives every call, so verify can check the payload of the last run
+ */
+template <typename Type>
+SortCall<Type>::SortCall(const TypedSortOption<Type>& _option, int n) :option(_option), rowIds(NULL)
+{
+    if (option.keyValueFunc == NULL)
+        return;
+    rowIds = new(std::nothrow) unsigned int[n > 0 ? n : 1];
+    if (rowIds == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+}
+
+/*
+ * Function Name:    operator()
+ * Function:         Run the option on arr
+ * Input Parameters: Type arr[]
+ *                   int n
+ *                   NullInstrument& ins / CountingInstrument& ins
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+template <typename Type>
+void SortCall<Type>::operator()(Type arr[], int n, NullInstrument& ins) const
+{
+    if (rowIds != NULL)
+        option.keyValueFunc(arr, rowIds, n, ins);
+    else
+        option.func(arr, n, ins);
+}
+
+template <typename Type>
+void SortCall<Type>::operator()(Type arr[], int n, CountingInstrument& ins) const
+{
+    if (rowIds != NULL)
+        option.countedKeyValueFunc(arr, rowIds, n, ins);
+    else
+        option.countedFunc(arr, n, ins);
+}
+
+/*
+ * Function Name:    verify
+ * Function:         Verify the output of the last run
+ * Input Parameters: const Type arr[]
+ *                   int n
+ *                   unsigned long long inputHash
+ *                   const Type input[]
+ * Return Value:     the verification result
+ * Notes:            Class external implementation of member functions
+ *                   Key/value options also have their row id column checked against the input keys
+ */
+template <typename Type>
+VerifyResult SortCall<Type>::verify(const Type arr[], int n, unsigned long long inputHash, const Type input[]) const
+{
+    VerifyResult result = verifySorted(arr, n, inputHash, option.stable);
+    if (rowIds != NULL)
+        result.merge(verifyRowIds(arr, rowIds, n, input));
+    return result;
+}
+
+/* Define SelectCall structure template, adapts a selection option and its rank to runCallBenchmark */
+template <typename Type>
+struct SelectCall {
+    const TypedSelectOption<Type>& option;
+    int k;
+    SelectCall(const TypedSelectOption<Type>& _option, int _k) :option(_option), k(_k) {}
+    void operator()(Type arr[], int n, NullInstrument& ins) const { option.func(arr, n, k, ins); }
+    void operator()(Type arr[], int n, CountingInstrument& ins) const { option.countedFunc(arr, n, k, ins); }
+    VerifyResult verify(const Type arr[], int n, unsigned long long inputHash, const Type[]) const { return verifySelected(arr, n, k, inputHash); }
+};
+
+/*
+ * Function Name:    runCallBenchmark
+ * Function:         Run an algorithm for warmup and measured repetitions
+ * Input Parameters: const Call& call
+ *                   const Type arr[]
+ *                   int n
+ *                   const BenchmarkConfig& config
+ * Return Value:     the benchmark result
+ * Notes:            Every repetition works on a fresh copy of arr, only the call is timed.
+ *                   The timed runs use the NullInstrument instantiation, the statistics come from one
+ *                   extra untimed run of the CountingInstrument instantiation. With config.verify every
+ *                   output is verified after its timer has stopped
+ */
+template <typename Type, typename Call>
+BenchmarkResult runCallBenchmark(const Call& call, const Type arr[], int n, const BenchmarkConfig& config)
+{
+    BenchmarkResult result;
+    Type* sortArr = new(std::nothrow) Type[n];
+    if (sortArr == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    double* times = new(std::nothrow) double[config.measuredReps];
+    if (times == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    HardwareCounters counters(config.useHardwareCounters);
+    unsigned long long values[HW_COUNTER_NUM];
+    for (int i = 0; i < HW_COUNTER_NUM; i++) {
+        result.counterValid[i] = counters.isValid(i);
+        result.counterValues[i] = 0;
+    }
+    VerifyResult input;
+    unsigned long long inputHash = config.verify ? verifyPass(arr, n, input) : 0;
+    result.verifyValid = config.verify;
+    for (int rep = 0; rep < config.warmupReps + config.measuredReps; rep++) {
+        bool measured = rep >= config.warmupReps;
+        std::copy(arr, arr + n, sortArr);
+        NullInstrument ins;
+        if (measured)
+            counters.start();
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        call(sortArr, n, ins);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        if (measured) {
+            counters.stop(values);
+            for (int i = 0; i < HW_COUNTER_NUM; i++)
+                result.counterValues[i] += values[i];
+            times[rep - config.warmupReps] = std::chrono::duration<double>(end - begin).count();
+        }
+        if (config.verify)
+            result.verify.merge(call.verify(sortArr, n, inputHash, arr));
+    }
+    std::sort(times, times + config.measuredReps);
+    int p99Index = (config.measuredReps * 99 + 99) / 100 - 1;
+    result.minTime = times[0];
+    result.medianTime = times[(config.measuredReps - 1) / 2];
+    result.p99Time = times[p99Index];
+    result.throughput = result.medianTime > 0 ? n / result.medianTime : 0;
+    result.statsValid = config.collectStats;
+    if (config.collectStats) {
+        CountingInstrument ins;
+        std::copy(arr, arr + n, sortArr);
+        call(sortArr, n, ins);
+        result.stats = ins.stats;
+        if (config.verify)
+            result.verify.merge(call.verify(sortArr, n, inputHash, arr));
+    }
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        result.counterValues[i] /= config.measuredReps;
+    //std::cout << ">>> 排序数组: ";
+    //for (int i = 0; i < n; i++)
+    //    std::cout << sortArr[i] << " ";
+    //std::cout << std::endl;
+    delete[] times;
+    delete[] sortArr;
+    return result;
+}
+
+/*
+ * Function Name:    runBenchmark
+ * Function:         Run a sorting algorithm for warmup and measured repetitions
+ * Input Parameters: const TypedSortOption<Type>& sortOption
+ *                   const Type arr[]
+ *                   int n
+ *                   const BenchmarkConfig& config
+ * Return Value:     the benchmark result
+ */
+template <typename Type>
+BenchmarkResult runBenchmark(const TypedSortOption<Type>& sortOption, const Type arr[], int n, const BenchmarkConfig& config)
+{
+    SortCall<Type> call(sortOption, n);
+    return runCallBenchmark(call, arr, n, config);
+}
+
+/*
+ * Function Name:    runBenchmark
+ * Function:         Run a selection algorithm for warmup and measured repetitions
+ * Input Parameters: const TypedSelectOption<Type>& selectOption
+ *                   int k
+ *                   const Type arr[]
+ *                   int n
+ *                   const BenchmarkConfig& config
+ * Return Value:     the benchmark result
+ */
+template <typename Type>
+BenchmarkResult runBenchmark(const TypedSelectOption<Type>& selectOption, int k, const Type arr[], int n, const BenchmarkConfig& config)
+{
+    return runCallBenchmark(SelectCall<Type>(selectOption, k), arr, n, config);
+}
+
+/*
+ * Function Name:    printCounterTable
+ * Function:         Print the hardware counters of several algorithms as a comparison table
+ * Input Parameters: const char* const names[]
+ *                   const BenchmarkResult results[]
+ *                   int count
+ *                   int n
+ * Return Value:     void
+ * Notes:            Every counter is divided by n, so a branch-bound algorithm shows a high branch_misses column and
+ *                   a memory-bound one high llc_misses and dtlb_misses columns with a low IPC. Counters that could
+ *                   not be opened are printed as -
+ */
+void printCounterTable(const char* const names[], const BenchmarkResult results[], int count, int n)
+{
+    const int nameWidth = 20, columnWidth = 14;
+    std::cout << std::endl << ">>> 硬件计数器对比 Hardware Counter Comparison (n = " << n << ", 每元素 per element)" << std::endl;
+    std::cout << std::left << std::setw(nameWidth) << "algorithm" << std::right << std::setw(columnWidth) << "median_s" << std::setw(columnWidth) << "IPC";
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        std::cout << std::setw(columnWidth) << hardwareEvents[i].name;
+    std::cout << std::endl;
+    std::cout << std::setiosflags(std::ios::fixed);
+    for (int r = 0; r < count; r++) {
+        const BenchmarkResult& result = results[r];
+        std::cout << std::left << std::setw(nameWidth) << names[r] << std::right << std::setprecision(6) << std::setw(columnWidth) << result.medianTime << std::setprecision(3);
+        if (result.counterValid[0] && result.counterValid[1] && result.counterValues[0] > 0)
+            std::cout << std::setw(columnWidth) << static_cast<double>(result.counterValues[1]) / result.counterValues[0];
+        else
+            std::cout << std::setw(columnWidth) << "-";
+        for (int i = 0; i < HW_COUNTER_NUM; i++)
+            if (result.counterValid[i])
+                std::cout << std::setw(columnWidth) << (n > 0 ? static_cast<double>(result.counterValues[i]) / n : 0.0);
+            else
+                std::cout << std::setw(columnWidth) << "-";
+        std::cout << std::endl;
+    }
+    std::cout << std::resetiosflags(std::ios::fixed);
+}
+
+/*
+ * Function Name:    performSort
+ * Function:         Sort function
+ * Input Parameters: const TypedSortOption<Type>& sortOption
+ *                   Type arr[]
+ *                   int n
+ *                   const BenchmarkConfig& config
+ * Return Value:     the benchmark result
+ */
+template <typename Type>
+BenchmarkResult performSort(const TypedSortOption<Type>& sortOption, Type arr[], int n, const BenchmarkConfig& config)
+{
+    std::cout << std::endl << ">>> 排序算法: " << sortOption.description << std::endl;
+    BenchmarkResult result = runBenchmark(sortOption, arr, n, config);
+    std::cout << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+    std::cout << ">>> 排序时间: " << result.medianTime << "s (最小 " << result.minTime << "s / 中位数 " << result.medianTime << "s / P99 " << result.p99Time << "s)" << std::endl;
+    std::cout << ">>> 吞 吐 量: " << std::setprecision(0) << result.throughput << " 元素/秒" << std::endl;
+    if (result.statsValid) {
+        std::cout << ">>> 比较次数: " << result.stats.comparisons << std::endl;
+        std::cout << ">>> 移动次数: " << result.stats.moves << std::endl;
+        std::cout << ">>> 分配内存: " << result.stats.allocatedBytes << " 字节" << std::endl;
+        std::cout << ">>> 递归深度: " << result.stats.maxDepth << std::endl;
+    }
+    if (result.verifyValid) {
+        std::cout << ">>> 结果校验: " << (result.verify.passed() ? "通过" : "失败");
+        if (!result.verify.ordered)
+            std::cout << " (未排序)";
+        if (!result.verify.permutation)
+            std::cout << " (元素不一致)";
+        if (!result.verify.stable)
+            std::cout << " (不稳定)";
+        std::cout << std::endl;
+    }
+    for (int i = 0; i < HW_COUNTER_NUM; i++)
+        if (result.counterValid[i])
+            std::cout << ">>> " << hardwareEvents[i].description << ": " << result.counterValues[i] << std::endl;
+    return result;
+}
+
+/* Define MappedFile class */
+class MappedFile {
+private:
+    char* data;
+    long long size;
+    bool writable;
+#ifdef __linux__
+    int fd;
+    void map(const char* filename, bool hugePages);
+#else
+    std::string name;
+#endif
+public:
+    MappedFile();
+    ~MappedFile() { close(); }
+    void open(const char* filename, bool _writable, bool hugePages);
+    void create(const char* filename, long long _size, bool hugePages);
+    void adviseRandom(void);
+    void close(void);
+    char* bytes(void) const { return data; }
+    long long length(void) const { return size; }
+};
+
+/*
+ * Function Name:    MappedFile
+ * Function:         Create an empty mapping
+ * Input Parameters: void
+ * Notes:            Class external implementation of member functions
+ */
+MappedFile::MappedFile() :data(NULL), size(0), writable(false)
+{
+#ifdef __linux__
+    fd = -1;
+#endif
+}
+
+#ifdef __linux__
+/*
+ * Function Name:    map
+ * Function:         Map the whole open file and hint the kernel
+ * Input Parameters: const char* filename
+ *                   bool hugePages
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   The mapping starts with sequential read-ahead, huge pages are a best-effort hint
+ */
+void MappedFile::map(const char* filename, bool hugePages)
+{
+    if (size == 0)
+        return;
+    void* addr = mmap(NULL, static_cast<size_t>(size), PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Failed to map file " << filename << "." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+    data = static_cast<char*>(addr);
+    madvise(data, static_cast<size_t>(size), MADV_SEQUENTIAL);
+    madvise(data, static_cast<size_t>(size), MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+    if (hugePages)
+        madvise(data, static_cast<size_t>(size), MADV_HUGEPAGE);
+#else
+    (void)hugePages;
+#endif
+}
+#endif
+
+/*
+ * Function Name:    open
+ * Function:         Map an existing file
+ * Input Parameters: const char* filename
+ *                   bool _writable
+ *                   bool hugePages
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   Without mmap the file is read into memory and written back by close when writable
+ */
+void MappedFile::open(const char* filename, bool _writable, bool hugePages)
+{
+    close();
+    writable = _writable;
+#ifdef __linux__
+    fd = ::open(filename, writable ? O_RDWR : O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Error: Failed to open file " << filename << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    size = static_cast<long long>(st.st_size);
+    map(filename, hugePages);
+#else
+    (void)hugePages;
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open file " << filename << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    name = filename;
+    size = static_cast<long long>(file.tellg());
+    data = new(std::nothrow) char[static_cast<size_t>(size) + 1];
+    if (data == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    file.seekg(0);
+    if (!file.read(data, static_cast<std::streamsize>(size))) {
+        std::cerr << "Error: Failed to read file " << filename << "." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+#endif
+}
+
+/*
+ * Function Name:    create
+ * Function:         Create or truncate a file of the given size and map it writable
+ * Input Parameters: const char* filename
+ *                   long long _size
+ *                   bool hugePages
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void MappedFile::create(const char* filename, long long _size, bool hugePages)
+{
+    close();
+    writable = true;
+    size = _size;
+#ifdef __linux__
+    fd = ::open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to create file " << filename << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Error: Failed to resize file " << filename << "." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+    map(filename, hugePages);
+#else
+    (void)hugePages;
+    name = filename;
+    data = new(std::nothrow) char[static_cast<size_t>(size) + 1];
+    if (data == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+#endif
+}
+
+/*
+ * Function Name:    adviseRandom
+ * Function:         Drop the sequential read-ahead hint before the mapping is sorted in place
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void MappedFile::adviseRandom(void)
+{
+#ifdef __linux__
+    if (data != NULL)
+        madvise(data, static_cast<size_t>(size), MADV_NORMAL);
+#endif
+}
+
+/*
+ * Function Name:    close
+ * Function:         Unmap the file
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void MappedFile::close(void)
+{
+#ifdef __linux__
+    if (data != NULL)
+        munmap(data, static_cast<size_t>(size));
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+#else
+    if (data != NULL && writable) {
+        std::ofstream file(name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.write(data, static_cast<std::streamsize>(size))) {
+            std::cerr << "Error: Failed to write file " << name << "." << std::endl;
+            exit(FILE_IO_ERROR);
+        }
+    }
+    delete[] data;
+#endif
+    data = NULL;
+    size = 0;
+}
+
+/*
+ * Function Name:    mappedElements
+ * Function:         Get the number of elements of Type in a mapped key file
+ * Input Parameters: const MappedFile& file
+ *                   const char* filename
+ * Return Value:     the number of elements
+ */
+template <typename Type>
+int mappedElements(const MappedFile& file, const char* filename)
+{
+    if (file.length() % sizeof(Type) != 0 || file.length() / static_cast<long long>(sizeof(Type)) > INT_MAX) {
+        std::cerr << "Error: The size of " << filename << " is not a multiple of " << sizeof(Type) << " bytes or exceeds " << INT_MAX << " elements." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+    return static_cast<int>(file.length() / static_cast<long long>(sizeof(Type)));
+}
+
+/* Define BatchOptions structure */
+struct BatchOptions {
+    const char* algos;
+    const char* type;
+    int sizes[MAX_BATCH_ITEMS];
+    int sizeNum;
+    int distIndices[MAX_BATCH_ITEMS];
+    int distNum;
+    GeneratorParams params;
+    unsigned long long seed;
+    bool json;
+    bool table;
+    BenchmarkConfig config;
+    const char* externalInput;
+    const char* outputFile;
+    const char* tempDir;
+    long long memoryLimit;
+    const char* inputFile;
+    const char* saveFile;
+    const char* sortFile;
+    bool hugePages;
+    int selectRank;
+};
+
+/*
+ * Function Name:    printUsage
+ * Function:         Print the command line usage
+ * Input Parameters: const char* program
+ * Return Value:     void
+ */
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << "  Without options the interactive menu is started." << std::endl << std::endl;
+    std::cout << "  --algos LIST          comma separated algorithm names or menu indices, or all (default: all)" << std::endl;
+    std::cout << "  --type TYPE           element type: int32, int64, double, pair or string16 (default: int32)" << std::endl;
+    std::cout << "                        types other than int32 run the generic algorithms" << std::endl;
+    std::cout << "  --sizes LIST          comma separated sizes, A..B sweeps powers of ten, e.g. 1e3..1e8 (default: 1e3..1e5)" << std::endl;
+    std::cout << "  --distribution LIST   comma separated input distributions, or all (default: uniform)" << std::endl;
+    std::cout << "  --swaps K             random swaps of the nearly-sorted distribution (default: 10)" << std::endl;
+    std::cout << "  --unique K            distinct keys of the few-unique distribution (default: 16)" << std::endl;
+    std::cout << "  --teeth K             ascending runs of the sawtooth distribution (default: 16)" << std::endl;
+    std::cout << "  --zipf-skew S         skew of the zipf distribution (default: 1.0)" << std::endl;
+    std::cout << "  --reps M              measured repetitions (default: 5)" << std::endl;
+    std::cout << "  --warmup N            warmup repetitions (default: 1)" << std::endl;
+    std::cout << "  --seed S              random seed (default: 1)" << std::endl;
+    std::cout << "  --format csv|json|table  output format, table compares the hardware counters per element (default: csv)" << std::endl;
+    std::cout << "  --threads N           threads of the parallel algorithms, 0 for all hardware threads (default: 0)" << std::endl;
+    std::cout << "  --cutoff N            range size below which the parallel algorithms run sequentially (default: 16384)" << std::endl;
+    std::cout << "  --no-counters         do not open hardware performance counters" << std::endl;
+    std::cout << "  --no-stats            skip the extra instrumented run that counts comparisons, moves, memory and depth" << std::endl;
+    std::cout << "  --no-verify           skip checking order, multiset hash and stability of every output" << std::endl;
+    std::cout << "  --select K            benchmark the selection algorithms moving the K-th smallest (0-based) element into place," << std::endl;
+    std::cout << "                        next to the full sorts of --algos (default: intro, or generic-intro for other types)" << std::endl << std::endl;
+    std::cout << "  External sort of a raw binary key file (--type int32 or int64):" << std::endl;
+    std::cout << "  --external FILE       input key file, enables the external merge sort" << std::endl;
+    std::cout << "  --output FILE         sorted output file" << std::endl;
+    std::cout << "  --memory MB           memory for runs and merge buffers (default: 1024)" << std::endl;
+    std::cout << "  --temp-dir DIR        directory of the temporary run files (default: .)" << std::endl << std::endl;
+    std::cout << "  Raw binary key files of --type, accessed through mmap:" << std::endl;
+    std::cout << "  --input FILE          benchmark on the keys of FILE instead of generated inputs" << std::endl;
+    std::cout << "  --save FILE           write the first --sizes / --distribution input to FILE and exit" << std::endl;
+    std::cout << "  --sort-file FILE      sort FILE in place with the single algorithm of --algos," << std::endl;
+    std::cout << "                        or into a second mapping when --output is given" << std::endl;
+    std::cout << "  --huge-pages          ask for transparent huge pages on the mappings" << std::endl << std::endl;
+    std::cout << "  Algorithms:";
+    for (int i = 0; i < sortOptionNum; i++)
+        std::cout << " " << sortOptions[i].name;
+    std::cout << std::endl << "  Generic algorithms:";
+    for (int i = 0; i < GENERIC_SORT_OPTION_NUM; i++)
+        std::cout << " " << GenericSortOptions<int>::options[i].name;
+    std::cout << std::endl << "  Selection algorithms:";
+    for (int i = 0; i < SELECT_OPTION_NUM; i++)
+        std::cout << " " << SelectOptions<int>::options[i].name;
+    std::cout << std::endl << "  Distributions:";
+    for (int i = 0; i < distributionOptionNum; i++)
+        std::cout << " " << distributionOptions[i].name;
+    std::cout << std::endl;
+}
+
+/*
+ * Function Name:    argumentError
+ * Function:         Report an invalid command line argument and exit
+ * Input Parameters: const char* option
+ *                   const char* value
+ * Return Value:     void
+ */
+void argumentError(const char* option, const char* value)
+{
+    std::cerr << "Error: Invalid value \"" << (value == NULL ? "" : value) << "\" for option " << option << "." << std::endl;
+    exit(INVALID_ARGUMENT_ERROR);
+}
+
+/*
+ * Function Name:    optionValue
+ * Function:         Get the value following a command line option
+ * Input Parameters: int argc
+ *                   char* argv[]
+ *                   int& i
+ * Return Value:     the option value
+ */
+const char* optionValue(int argc, char* argv[], int& i)
+{
+    if (i + 1 >= argc)
+        argumentError(argv[i], NULL);
+    return argv[++i];
+}
+
+/*
+ * Function Name:    parseSize
+ * Function:         Parse an array size such as 100000 or 1e5
+ * Input Parameters: const char* str
+ *                   const char* end
+ * Return Value:     the size, or -1 if it is invalid
+ */
+int parseSize(const char* str, const char* end)
+{
+    char* parseEnd;
+    double value = strtod(str, &parseEnd);
+    if (parseEnd != end || parseEnd == str || value < 1 || value > INT_MAX || value != static_cast<int>(value))
+        return -1;
+    return static_cast<int>(value);
+}
+
+/*
+ * Function Name:    parseAlgos
+ * Function:         Parse the --algos list against the sort options of an element type
+ * Input Parameters: const char* str
+ *                   const TypedSortOption<Type> table[]
+ *                   int tableNum
+ *                   int indices[]
+ * Return Value:     the number of selected algorithms
+ */
+template <typename Type>
+int parseAlgos(const char* str, const TypedSortOption<Type> table[], int tableNum, int indices[])
+{
+    int num = 0;
+    if (strcmp(str, "all") == 0) {
+        for (int i = 0; i < tableNum && i < MAX_BATCH_ITEMS; i++)
+            indices[num++] = i;
+        return num;
+    }
+    while (*str) {
+        const char* end = strchr(str, ',');
+        if (end == NULL)
+            end = str + strlen(str);
+        size_t len = static_cast<size_t>(end - str);
+        int index = -1;
+        for (int i = 0; i < tableNum; i++)
+            if (strlen(table[i].name) == len && strncmp(table[i].name, str, len) == 0)
+                index = i;
+        if (index < 0) {
+            char* parseEnd;
+            long value = strtol(str, &parseEnd, 10);
+            if (parseEnd == end && value >= 1 && value <= tableNum)
+                index = static_cast<int>(value) - 1;
+        }
+        if (index < 0 || num == MAX_BATCH_ITEMS)
+            argumentError("--algos", str);
+        indices[num++] = index;
+        str = *end ? end + 1 : end;
+    }
+    return num;
+}
+
+/*
+ * Function Name:    parseDistributions
+ * Function:         Parse the --distribution list
+ * Input Parameters: const char* str
+ *                   BatchOptions& options
+ * Return Value:     void
+ */
+void parseDistributions(const char* str, BatchOptions& options)
+{
+    options.distNum = 0;
+    if (strcmp(str, "all") == 0) {
+        for (int i = 0; i < distributionOptionNum && i < MAX_BATCH_ITEMS; i++)
+            options.distIndices[options.distNum++] = i;
+        return;
+    }
+    while (*str) {
+        const char* end = strchr(str, ',');
+        if (end == NULL)
+            end = str + strlen(str);
+        size_t len = static_cast<size_t>(end - str);
+        int index = -1;
+        for (int i = 0; i < distributionOptionNum; i++)
+            if (strlen(distributionOptions[i].name) == len && strncmp(distributionOptions[i].name, str, len) == 0)
+                index = i;
+        if (index < 0 || options.distNum == MAX_BATCH_ITEMS)
+            argumentError("--distribution", str);
+        options.distIndices[options.distNum++] = index;
+        str = *end ? end + 1 : end;
+    }
+}
+
+/*
+ * Function Name:    parsePositive
+ * Function:         Parse a positive integer option value
+ * Input Parameters: const char* option
+ *                   const char* value
+ * Return Value:     the value
+ */
+int parsePositive(const char* option, const char* value)
+{
+    char* parseEnd;
+    long result = strtol(value, &parseEnd, 10);
+    if (*parseEnd != '\0' || parseEnd == value || result < 1 || result > INT_MAX)
+        argumentError(option, value);
+    return static_cast<int>(result);
+}
+
+/*
+ * Function Name:    parseSizes
+ * Function:         Parse the --sizes list
+ * Input Parameters: const char* str
+ *                   BatchOptions& options
+ * Return Value:     void
+ */
+void parseSizes(const char* str, BatchOptions& options)
+{
+    options.sizeNum = 0;
+    while (*str) {
+        const char* end = strchr(str, ',');
+        if (end == NULL)
+            end = str + strlen(str);
+        const char* range = strstr(str, "..");
+        if (range != NULL && range < end) {
+            int low = parseSize(str, range), high = parseSize(range + 2, end);
+            if (low < 0 || high < low)
+                argumentError("--sizes", str);
+            for (double size = low; size <= high; size *= 10) {
+                if (options.sizeNum == MAX_BATCH_ITEMS)
+                    argumentError("--sizes", str);
+                options.sizes[options.sizeNum++] = static_cast<int>(size);
+            }
+        }
+        else {
+            int size = parseSize(str, end);
+            if (size < 0 || options.sizeNum == MAX_BATCH_ITEMS)
+                argumentError("--sizes", str);
+            options.sizes[options.sizeNum++] = size;
+        }
+        str = *end ? end + 1 : end;
+    }
+}
+
+/*
+ * Function Name:    parseBatchOptions
+ * Function:         Parse the command line arguments
+ * Input Parameters: int argc
+ *                   char* argv[]
+ *                   BatchOptions& options
+ * Return Value:     void
+ */
+void parseBatchOptions(int argc, char* argv[], BatchOptions& options)
+{
+    options.algos = NULL;
+    options.type = "int32";
+    parseSizes("1e3..1e5", options);
+    parseDistributions("uniform", options);
+    options.params = defaultGeneratorParams;
+    options.seed = 1;
+    options.json = false;
+    options.table = false;
+    options.config.warmupReps = 1;
+    options.config.measuredReps = 5;
+    options.config.useHardwareCounters = true;
+    options.config.collectStats = true;
+    options.config.verify = true;
+    options.externalInput = NULL;
+    options.outputFile = NULL;
+    options.tempDir = ".";
+    options.memoryLimit = 1024LL << 20;
+    options.inputFile = NULL;
+    options.saveFile = NULL;
+    options.sortFile = NULL;
+    options.hugePages = false;
+    options.selectRank = -1;
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        char* parseEnd;
+        if (strcmp(option, "--help") == 0 || strcmp(option, "-h") == 0) {
+            printUsage(argv[0]);
+            exit(0);
+        }
+        else if (strcmp(option, "--no-counters") == 0)
+            options.config.useHardwareCounters = false;
+        else if (strcmp(option, "--no-stats") == 0)
+            options.config.collectStats = false;
+        else if (strcmp(option, "--no-verify") == 0)
+            options.config.verify = false;
+        else if (strcmp(option, "--algos") == 0)
+            options.algos = optionValue(argc, argv, i);
+        else if (strcmp(option, "--sizes") == 0)
+            parseSizes(optionValue(argc, argv, i), options);
+        else if (strcmp(option, "--type") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            if (strcmp(value, "int32") != 0 && strcmp(value, "int64") != 0 && strcmp(value, "double") != 0 && strcmp(value, "pair") != 0 && strcmp(value, "string16") != 0)
+                argumentError(option, value);
+            options.type = value;
+        }
+        else if (strcmp(option, "--distribution") == 0)
+            parseDistributions(optionValue(argc, argv, i), options);
+        else if (strcmp(option, "--swaps") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            long swaps = strtol(value, &parseEnd, 10);
+            if (*parseEnd != '\0' || swaps < 0 || swaps > INT_MAX)
+                argumentError(option, value);
+            options.params.swaps = static_cast<int>(swaps);
+        }
+        else if (strcmp(option, "--threads") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            long threads = strtol(value, &parseEnd, 10);
+            if (*parseEnd != '\0' || threads < 0 || threads > 4096)
+                argumentError(option, value);
+            parallelConfig.threadCount = static_cast<int>(threads);
+        }
+        else if (strcmp(option, "--cutoff") == 0)
+            parallelConfig.sequentialCutoff = parsePositive(option, optionValue(argc, argv, i));
+        else if (strcmp(option, "--unique") == 0)
+            options.params.uniqueKeys = parsePositive(option, optionValue(argc, argv, i));
+        else if (strcmp(option, "--teeth") == 0)
+            options.params.teeth = parsePositive(option, optionValue(argc, argv, i));
+        else if (strcmp(option, "--zipf-skew") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            double skew = strtod(value, &parseEnd);
+            if (*parseEnd != '\0' || !(skew > 0 && skew <= 10))
+                argumentError(option, value);
+            options.params.zipfSkew = skew;
+        }
+        else if (strcmp(option, "--reps") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            long reps = strtol(value, &parseEnd, 10);
+            if (*parseEnd != '\0' || reps < 1 || reps > 100000)
+                argumentError(option, value);
+            options.config.measuredReps = static_cast<int>(reps);
+        }
+        else if (strcmp(option, "--warmup") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            long reps = strtol(value, &parseEnd, 10);
+            if (*parseEnd != '\0' || reps < 0 || reps > 100000)
+                argumentError(option, value);
+            options.config.warmupReps = static_cast<int>(reps);
+        }
+        else if (strcmp(option, "--seed") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            unsigned long long seed = strtoull(value, &parseEnd, 10);
+            if (*parseEnd != '\0')
+                argumentError(option, value);
+            options.seed = seed;
+        }
+        else if (strcmp(option, "--external") == 0)
+            options.externalInput = optionValue(argc, argv, i);
+        else if (strcmp(option, "--output") == 0)
+            options.outputFile = optionValue(argc, argv, i);
+        else if (strcmp(option, "--temp-dir") == 0)
+            options.tempDir = optionValue(argc, argv, i);
+        else if (strcmp(option, "--memory") == 0)
+            options.memoryLimit = static_cast<long long>(parsePositive(option, optionValue(argc, argv, i))) << 20;
+        else if (strcmp(option, "--input") == 0)
+            options.inputFile = optionValue(argc, argv, i);
+        else if (strcmp(option, "--save") == 0)
+            options.saveFile = optionValue(argc, argv, i);
+        else if (strcmp(option, "--sort-file") == 0)
+            options.sortFile = optionValue(argc, argv, i);
+        else if (strcmp(option, "--huge-pages") == 0)
+            options.hugePages = true;
+        else if (strcmp(option, "--select") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            long rank = strtol(value, &parseEnd, 10);
+            if (*parseEnd != '\0' || rank < 0 || rank >= INT_MAX)
+                argumentError(option, value);
+            options.selectRank = static_cast<int>(rank);
+        }
+        else if (strcmp(option, "--format") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            options.json = strcmp(value, "json") == 0;
+            options.table = strcmp(value, "table") == 0;
+            if (!options.json && !options.table && strcmp(value, "csv") != 0)
+                argumentError(option, value);
+        }
+        else {
+            std::cerr << "Error: Unknown option " << option << "." << std::endl;
+            exit(INVALID_ARGUMENT_ERROR);
+        }
+    }
+    if ((options.externalInput != NULL && options.outputFile == NULL) || (options.outputFile != NULL && options.externalInput == NULL && options.sortFile == NULL)) {
+        std::cerr << "Error: --output needs --external or --sort-file, and --external needs --output." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    if (options.algos == NULL)
+        options.algos = options.selectRank < 0 ? "all" : strcmp(options.type, "int32") == 0 ? "intro" : "generic-intro";
+}
+
+/*
+ * Function Name:    printBatchResult
+ * Function:         Print one benchmark result as a CSV row or a JSON object
+ * Input Parameters: const BatchOptions& options
+ *                   const char* algoName
+ *                   const DistributionOption& distOption
+ *                   int n
+ *                   const BenchmarkResult& result
+ *                   bool first
+ * Return Value:     void
+ */
+void printBatchResult(const BatchOptions& options, const char* algoName, const DistributionOption& distOption, int n, const BenchmarkResult& result, bool first)
+{
+    std::cout << std::setprecision(9);
+    if (options.json) {
+        std::cout << (first ? "  {" : ",\n  {") << "\"algorithm\": \"" << algoName << "\", \"type\": \"" << options.type << "\", \"distribution\": \"" << distOption.name << "\", \"size\": " << n
+            << ", \"reps\": " << options.config.measuredReps << ", \"min_s\": " << result.minTime << ", \"median_s\": " << result.medianTime << ", \"p99_s\": " << result.p99Time
+            << ", \"throughput_eps\": " << result.throughput;
+        if (result.statsValid)
+            std::cout << ", \"comparisons\": " << result.stats.comparisons << ", \"moves\": " << result.stats.moves << ", \"allocated_bytes\": " << result.stats.allocatedBytes
+                << ", \"max_depth\": " << result.stats.maxDepth;
+        else
+            std::cout << ", \"comparisons\": null, \"moves\": null, \"allocated_bytes\": null, \"max_depth\": null";
+        for (int i = 0; i < HW_COUNTER_NUM; i++) {
+            std::cout << ", \"" << hardwareEvents[i].name << "\": ";
+            if (result.counterValid[i])
+                std::cout << result.counterValues[i];
+            else
+                std::cout << "null";
+        }
+        std::cout << ", \"verified\": " << (result.verifyValid ? (result.verify.passed() ? "true" : "false") : "null");
+        if (options.selectRank >= 0)
+            std::cout << ", \"rank\": " << options.selectRank;
+        std::cout << "}" << std::flush;
+    }
+    else {
+        std::cout << algoName << "," << options.type << "," << distOption.name << "," << n << "," << options.config.measuredReps << "," << result.minTime << "," << result.medianTime << ","
+            << result.p99Time << "," << result.throughput << ",";
+        if (result.statsValid)
+            std::cout << result.stats.comparisons << "," << result.stats.moves << "," << result.stats.allocatedBytes << "," << result.stats.maxDepth;
+        else
+            std::cout << ",,,";
+        for (int i = 0; i < HW_COUNTER_NUM; i++) {
+            std::cout << ",";
+            if (result.counterValid[i])
+                std::cout << result.counterValues[i];
+        }
+        std::cout << "," << (result.verifyValid ? (result.verify.passed() ? "true" : "false") : "");
+        if (options.selectRank >= 0)
+            std::cout << "," << options.selectRank;
+        std::cout << std::endl;
+    }
+}
+
+/*
+ * Function Name:    keyToValue
+ * Function:         Convert a generated key to a benchmark element
+ * Input Parameters: long long key
+ *                   int index
+ *                   Type& value
+ * Return Value:     void
+ * Notes:            The conversions keep the order of the keys
+ */
+inline void keyToValue(long long key, int index, int& value)
+{
+    (void)index;
+    value = static_cast<int>(key);
+}
+
+inline void keyToValue(long long key, int index, long long& value)
+{
+    (void)index;
+    value = key;
+}
+
+inline void keyToValue(long long key, int index, double& value)
+{
+    (void)index;
+    value = static_cast<double>(key) / 1048576.0;
+}
+
+inline void keyToValue(long long key, int index, KeyIndexPair& value)
+{
+    value.first = key;
+    value.second = index;
+}
+
+inline void keyToValue(long long key, int index, FixedString& value)
+{
+    (void)index;
+    for (int i = FIXED_STRING_LENGTH - 1; i >= 0; i--, key >>= 4)
+        value.data[i] = "0123456789abcdef"[key & 15];
+}
+
+/*
+ * Function Name:    generateInput
+ * Function:         Fill arr with a distribution
+ * Input Parameters: const DistributionOption& distOption
+ *                   Type arr[]
+ *                   int n
+ *                   const BatchOptions& options
+ * Return Value:     void
+ * Notes:            Element types other than int are converted from 64-bit keys
+ */
+template <typename Type>
+void generateInput(const DistributionOption& distOption, Type arr[], int n, const BatchOptions& options)
+{
+    long long* keys = new(std::nothrow) long long[n];
+    if (keys == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    Xoshiro256 rng(options.seed);
+    distOption.func64(keys, n, rng, options.params);
+    for (int i = 0; i < n; i++)
+        keyToValue(keys[i], i, arr[i]);
+    delete[] keys;
+}
+
+inline void generateInput(const DistributionOption& distOption, int arr[], int n, const BatchOptions& options)
+{
+    Xoshiro256 rng(options.seed);
+    distOption.func(arr, n, rng, options.params);
+}
+
+/*
+ * Function Name:    saveInput
+ * Function:         Generate the first selected size and distribution straight into a mapped file
+ * Input Parameters: const BatchOptions& options
+ * Return Value:     void
+ */
+template <typename Type>
+void saveInput(const BatchOptions& options)
+{
+    int n = options.sizes[0];
+    const DistributionOption& distOption = distributionOptions[options.distIndices[0]];
+    MappedFile file;
+    file.create(options.saveFile, static_cast<long long>(n) * sizeof(Type), options.hugePages);
+    generateInput(distOption, reinterpret_cast<Type*>(file.bytes()), n, options);
+    file.close();
+    std::cout << ">>> 保存输入: " << options.saveFile << " (" << n << " 个 " << options.type << " 元素，输入分布: " << distOption.name << "，种子: " << options.seed << ")" << std::endl;
+}
+
+/*
+ * Function Name:    sortFile
+ * Function:         Sort a mapped key file in place, or into a second mapping when --output is given
+ * Input Parameters: const BatchOptions& options
+ *                   const TypedSortOption<Type> table[]
+ *                   int tableNum
+ * Return Value:     void
+ * Notes:            The keys are sorted directly on the page cache, there is no parse or copy step
+ */
+template <typename Type>
+void sortFile(const BatchOptions& options, const TypedSortOption<Type> table[], int tableNum)
+{
+    int algoIndices[MAX_BATCH_ITEMS];
+    if (parseAlgos(options.algos, table, tableNum, algoIndices) != 1) {
+        std::cerr << "Error: --sort-file needs exactly one algorithm in --algos." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    const TypedSortOption<Type>& sortOption = table[algoIndices[0]];
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    MappedFile input, output;
+    input.open(options.sortFile, options.outputFile == NULL, options.hugePages);
+    int n = mappedElements<Type>(input, options.sortFile);
+    MappedFile& target = options.outputFile == NULL ? input : output;
+    if (options.outputFile != NULL) {
+        output.create(options.outputFile, input.length(), options.hugePages);
+        if (n > 0)
+            memcpy(output.bytes(), input.bytes(), static_cast<size_t>(input.length()));
+        input.close();
+    }
+    target.adviseRandom();
+    std::chrono::steady_clock::time_point loaded = std::chrono::steady_clock::now();
+    NullInstrument ins;
+    sortOption.func(reinterpret_cast<Type*>(target.bytes()), n, ins);
+    std::chrono::steady_clock::time_point sorted = std::chrono::steady_clock::now();
+    target.close();
+    double loadTime = std::chrono::duration<double>(loaded - begin).count();
+    double sortTime = std::chrono::duration<double>(sorted - loaded).count();
+    std::cout << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+    std::cout << ">>> 文件排序: " << options.sortFile << " -> " << (options.outputFile == NULL ? options.sortFile : options.outputFile) << std::endl;
+    std::cout << ">>> 排序算法: " << sortOption.description << std::endl;
+    std::cout << ">>> 元素数量: " << n << " (" << options.type << ")" << std::endl;
+    std::cout << ">>> 映射时间: " << loadTime << "s" << std::endl;
+    std::cout << ">>> 排序时间: " << sortTime << "s" << std::endl;
+    std::cout << ">>> 吞 吐 量: " << std::setprecision(0) << (sortTime > 0 ? n / sortTime : 0) << " 元素/秒" << std::endl;
+}
+
+/*
+ * Function Name:    reportVerifyFailure
+ * Function:         Report a failed output verification on stderr
+ * Input Parameters: const char* algoName
+ *                   const DistributionOption& distOption
+ *                   int n
+ *                   const BenchmarkResult& result
+ * Return Value:     void
+ */
+void reportVerifyFailure(const char* algoName, const DistributionOption& distOption, int n, const BenchmarkResult& result)
+{
+    if (!result.verifyValid || result.verify.passed())
+        return;
+    std::cerr << "Error: " << algoName << " failed verification on " << distOption.name << " input of size " << n << ":"
+        << (result.verify.ordered ? "" : " not ordered") << (result.verify.permutation ? "" : " not a permutation of the input")
+        << (result.verify.stable ? "" : " not stable") << "." << std::endl;
+}
+
+/*
+ * Function Name:    benchmarkInput
+ * Function:         Benchmark the selected algorithms on one input and print the results
+ * Input Parameters: const BatchOptions& options
+ *                   const TypedSortOption<Type> table[]
+ *                   const int algoIndices[]
+ *                   int algoNum
+ *                   const Type arr[]
+ *                   int n
+ *                   const DistributionOption& distOption
+ *                   bool& first
+ * Return Value:     void
+ * Notes:            With --select the selection algorithms run first, and the sorts of --algos are the baseline.
+ *                   The table format prints all results of the input together once they are complete
+ */
+template <typename Type>
+void benchmarkInput(const BatchOptions& options, const TypedSortOption<Type> table[], const int algoIndices[], int algoNum, const Type arr[], int n, const DistributionOption& distOption, bool& first)
+{
+    if (options.selectRank >= n) {
+        std::cerr << "Error: --select rank " << options.selectRank << " is not below the size " << n << "." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    const char* names[SELECT_OPTION_NUM + MAX_BATCH_ITEMS];
+    BenchmarkResult results[SELECT_OPTION_NUM + MAX_BATCH_ITEMS];
+    int count = 0;
+    for (int i = 0; i < SELECT_OPTION_NUM + algoNum; i++) {
+        if (i < SELECT_OPTION_NUM && options.selectRank < 0)
+            continue;
+        if (i < SELECT_OPTION_NUM) {
+            names[count] = SelectOptions<Type>::options[i].name;
+            results[count] = runBenchmark(SelectOptions<Type>::options[i], options.selectRank, arr, n, options.config);
+        }
+        else {
+            names[count] = table[algoIndices[i - SELECT_OPTION_NUM]].name;
+            results[count] = runBenchmark(table[algoIndices[i - SELECT_OPTION_NUM]], arr, n, options.config);
+        }
+        if (!options.table)
+            printBatchResult(options, names[count], distOption, n, results[count], first);
+        reportVerifyFailure(names[count], distOption, n, results[count]);
+        first = false;
+        count++;
+    }
+    if (options.table) {
+        std::cout << std::endl << ">>> 输入分布: " << distOption.name;
+        if (options.selectRank >= 0)
+            std::cout << "，选择位置: " << options.selectRank;
+        printCounterTable(names, results, count, n);
+    }
+}
+
+/*
+ * Function Name:    runBatch
+ * Function:         Run every selected algorithm on every selected size without interaction
+ * Input Parameters: const BatchOptions& options
+ *                   const TypedSortOption<Type> table[]
+ *                   int tableNum
+ * Return Value:     void
+ * Notes:            With --input the keys of the mapped file replace the generated sizes and distributions
+ */
+template <typename Type>
+void runBatch(const BatchOptions& options, const TypedSortOption<Type> table[], int tableNum)
+{
+    if (options.saveFile != NULL) {
+        saveInput<Type>(options);
+        return;
+    }
+    if (options.sortFile != NULL) {
+        sortFile(options, table, tableNum);
+        return;
+    }
+    int algoIndices[MAX_BATCH_ITEMS];
+    int algoNum = parseAlgos(options.algos, table, tableNum, algoIndices);
+    if (options.json)
+        std::cout << "[" << std::endl;
+    else if (!options.table) {
+        std::cout << "algorithm,type,distribution,size,reps,min_s,median_s,p99_s,throughput_eps,comparisons,moves,allocated_bytes,max_depth";
+        for (int i = 0; i < HW_COUNTER_NUM; i++)
+            std::cout << "," << hardwareEvents[i].name;
+        std::cout << ",verified" << (options.selectRank >= 0 ? ",rank" : "") << std::endl;
+    }
+    bool first = true;
+    if (options.inputFile != NULL) {
+        MappedFile file;
+        file.open(options.inputFile, false, options.hugePages);
+        int n = mappedElements<Type>(file, options.inputFile);
+        benchmarkInput(options, table, algoIndices, algoNum, reinterpret_cast<const Type*>(file.bytes()), n, fileDistribution, first);
+    }
+    for (int s = 0; s < options.sizeNum && options.inputFile == NULL; s++) {
+        int n = options.sizes[s];
+        Type* arr = new(std::nothrow) Type[n];
+        if (arr == NULL) {
+            std::cerr << "Error: Memory allocation failed." << std::endl;
+            exit(MEMORY_ALLOCATION_ERROR);
+        }
+        for (int d = 0; d < options.distNum; d++) {
+            const DistributionOption& distOption = distributionOptions[options.distIndices[d]];
+            generateInput(distOption, arr, n, options);
+            benchmarkInput(options, table, algoIndices, algoNum, arr, n, distOption, first);
+        }
+        delete[] arr;
+    }
+    if (options.json)
+        std::cout << std::endl << "]" << std::endl;
+}
+
+/*
+ * Function Name:    runBatch
+ * Function:         Run the batch mode for the element type selected by --type
+ * Input Parameters: const BatchOptions& options
+ * Return Value:     void
+ */
+void runBatch(const BatchOptions& options)
+{
+    if (strcmp(options.type, "int64") == 0)
+        runBatch(options, GenericSortOptions<long long>::options, GENERIC_SORT_OPTION_NUM);
+    else if (strcmp(options.type, "double") == 0)
+        runBatch(options, GenericSortOptions<double>::options, GENERIC_SORT_OPTION_NUM);
+    else if (strcmp(options.type, "pair") == 0)
+        runBatch(options, GenericSortOptions<KeyIndexPair>::options, GENERIC_SORT_OPTION_NUM);
+    else if (strcmp(options.type, "string16") == 0)
+        runBatch(options, GenericSortOptions<FixedString>::options, GENERIC_SORT_OPTION_NUM);
+    else
+        runBatch(options, sortOptions, sortOptionNum);
+}
+
+/* Define RunReader class template */
+template <typename Type>
+class RunReader {
+private:
+    std::ifstream file;
+    Type* buffer;
+    long long remaining;
+    int capacity;
+    int size;
+    int pos;
+    void fill(void);
+public:
+    RunReader() :buffer(NULL), remaining(0), capacity(0), size(0), pos(0) {}
+    ~RunReader() { delete[] buffer; }
+    void open(const std::string& filename, long long count, int bufferSize);
+    bool empty(void) const { return pos == size; }
+    const Type& head(void) const { return buffer[pos]; }
+    void pop(void) { if (++pos == size) fill(); }
+};
+
+/*
+ * Function Name:    open
+ * Function:         Open a sorted run and read its first block
+ * Input Parameters: const std::string& filename
+ *                   long long count
+ *                   int bufferSize
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+template <typename Type>
+void RunReader<Type>::open(const std::string& filename, long long count, int bufferSize)
+{
+    file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to open file " << filename << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    capacity = static_cast<int>(std::min<long long>(bufferSize, std::max(1LL, count)));
+    buffer = new(std::nothrow) Type[capacity];
+    if (buffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    remaining = count;
+    fill();
+}
+
+/*
+ * Function Name:    fill
+ * Function:         Read the next block of the run into the buffer
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+template <typename Type>
+void RunReader<Type>::fill(void)
+{
+    size = static_cast<int>(std::min<long long>(capacity, remaining));
+    pos = 0;
+    if (size == 0)
+        return;
+    file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size) * sizeof(Type));
+    if (file.gcount() != static_cast<std::streamsize>(size) * static_cast<std::streamsize>(sizeof(Type))) {
+        std::cerr << "Error: Failed to read a sorted run." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+    remaining -= size;
+}
+
+/* Define LoserTree class template */
+template <typename Type>
+class LoserTree {
+private:
+    RunReader<Type>* sources;
+    int k;
+    int* tree;
+    bool less(int a, int b) const;
+public:
+    LoserTree(RunReader<Type> _sources[], int _k);
+    ~LoserTree() { delete[] tree; }
+    bool empty(void) const { return sources[tree[0]].empty(); }
+    const Type& top(void) const { return sources[tree[0]].head(); }
+    void pop(void);
+};
+
+/*
+ * Function Name:    less
+ * Function:         Play one game between two sources
+ * Input Parameters: int a
+ *                   int b
+ * Return Value:     true when the head of a wins
+ * Notes:            Class external implementation of member functions
+ *                   An exhausted source loses every game
+ */
+template <typename Type>
+bool LoserTree<Type>::less(int a, int b) const
+{
+    if (sources[a].empty())
+        return false;
+    if (sources[b].empty())
+        return true;
+    return sources[a].head() < sources[b].head();
+}
+
+/*
+ * Function Name:    LoserTree
+ * Function:         Build the tournament over k sources
+ * Input Parameters: RunReader<Type> _sources[]
+ *                   int _k
+ * Notes:            Class external implementation of member functions
+ *                   Leaf i sits at node k + i, node 0 holds the winner and every inner node the loser of its game
+ */
+template <typename Type>
+LoserTree<Type>::LoserTree(RunReader<Type> _sources[], int _k) :sources(_sources), k(_k)
+{
+    tree = new(std::nothrow) int[k];
+    int* winner = new(std::nothrow) int[2 * k];
+    if (tree == NULL || winner == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    for (int i = 0; i < k; i++)
+        winner[k + i] = i;
+    for (int node = k - 1; node > 0; node--) {
+        int left = winner[2 * node], right = winner[2 * node + 1];
+        bool rightWins = less(right, left);
+        winner[node] = rightWins ? right : left;
+        tree[node] = rightWins ? left : right;
+    }
+    tree[0] = k == 1 ? 0 : winner[1];
+    delete[] winner;
+}
+
+/*
+ * Function Name:    pop
+ * Function:         Advance the winning source and replay its path to the root
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   One game per level, so every output element costs log2(k) comparisons
+ */
+template <typename Type>
+void LoserTree<Type>::pop(void)
+{
+    int w = tree[0];
+    sources[w].pop();
+    for (int node = (w + k) / 2; node > 0; node /= 2)
+        if (less(tree[node], w))
+            std::swap(tree[node], w);
+    tree[0] = w;
+}
+
+/*
+ * Function Name:    writeBlock
+ * Function:         Write a block of elements to a binary file
+ * Input Parameters: std::ofstream& file
+ *                   const Type arr[]
+ *                   long long n
+ * Return Value:     void
+ */
+template <typename Type>
+void writeBlock(std::ofstream& file, const Type arr[], long long n)
+{
+    file.write(reinterpret_cast<const char*>(arr), static_cast<std::streamsize>(n) * sizeof(Type));
+    if (!file) {
+        std::cerr << "Error: Failed to write file." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+}
+
+/*
+ * Function Name:    openOutput
+ * Function:         Create a binary output file
+ * Input Parameters: std::ofstream& file
+ *                   const std::string& filename
+ * Return Value:     void
+ */
+void openOutput(std::ofstream& file, const std::string& filename)
+{
+    file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Failed to create file " << filename << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+}
+
+/*
+ * Function Name:    mergeRunFiles
+ * Function:         K-way merge of sorted run files into one file through a loser tree
+ * Input Parameters: const std::string names[]
+ *                   const long long counts[]
+ *                   int k
+ *                   const std::string& output
+ *                   long long memoryLimit
+ * Return Value:     void
+ * Notes:            The memory is split evenly between the k input buffers and the output buffer
+ */
+template <typename Type>
+void mergeRunFiles(const std::string names[], const long long counts[], int k, const std::string& output, long long memoryLimit)
+{
+    int bufferSize = static_cast<int>(std::min<long long>(INT_MAX, std::max(1LL, memoryLimit / ((k + 1) * static_cast<long long>(sizeof(Type))))));
+    RunReader<Type>* sources = new(std::nothrow) RunReader<Type>[k];
+    Type* outBuffer = new(std::nothrow) Type[bufferSize];
+    if (sources == NULL || outBuffer == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    for (int i = 0; i < k; i++)
+        sources[i].open(names[i], counts[i], bufferSize);
+    std::ofstream file;
+    openOutput(file, output);
+    LoserTree<Type> tree(sources, k);
+    int outSize = 0;
+    while (!tree.empty()) {
+        outBuffer[outSize++] = tree.top();
+        tree.pop();
+        if (outSize == bufferSize) {
+            writeBlock(file, outBuffer, outSize);
+            outSize = 0;
+        }
+    }
+    writeBlock(file, outBuffer, outSize);
+    file.close();
+    delete[] outBuffer;
+    delete[] sources;
+}
+
+/*
+ * Function Name:    tempRunName
+ * Function:         Get the file name of a temporary run
+ * Input Parameters: const char* tempDir
+ *                   long long stamp
+ *                   int index
+ * Return Value:     the file name
+ */
+std::string tempRunName(const char* tempDir, long long stamp, int index)
+{
+    return std::string(tempDir) + "/external_sort_" + std::to_string(stamp) + "_" + std::to_string(index) + ".tmp";
+}
+
+/*
+ * Function Name:    externalSort
+ * Function:         Sort a binary key file that does not fit in memory
+ * Input Parameters: const BatchOptions& options
+ * Return Value:     void
+ * Notes:            Runs of memoryLimit / (2 * sizeof(Type)) keys are radix sorted in memory and spilled to
+ *                   tempDir, then merged with fan-in memoryLimit / EXTERNAL_MIN_BUFFER - 1 per pass
+ */
+template <typename Type>
+void externalSort(const BatchOptions& options)
+{
+    std::ifstream input(options.externalInput, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!input.is_open()) {
+        std::cerr << "Error: Failed to open file " << options.externalInput << "." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    long long fileSize = static_cast<long long>(input.tellg());
+    if (fileSize % sizeof(Type) != 0) {
+        std::cerr << "Error: The size of " << options.externalInput << " is not a multiple of " << sizeof(Type) << " bytes." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+    input.seekg(0);
+    long long total = fileSize / sizeof(Type);
+    int runCapacity = static_cast<int>(std::min<long long>(INT_MAX, std::max(1LL, options.memoryLimit / (2 * static_cast<long long>(sizeof(Type))))));
+    int runNum = static_cast<int>(std::max(1LL, (total + runCapacity - 1) / runCapacity));
+    long long stamp = static_cast<long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string* names = new(std::nothrow) std::string[runNum];
+    long long* counts = new(std::nothrow) long long[runNum];
+    Type* run = new(std::nothrow) Type[std::min<long long>(runCapacity, std::max(1LL, total))];
+    if (names == NULL || counts == NULL || run == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+
+    /* Run formation */
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    int nameIndex = 0;
+    for (int r = 0; r < runNum; r++) {
+        int n = static_cast<int>(std::min<long long>(runCapacity, total - static_cast<long long>(r) * runCapacity));
+        input.read(reinterpret_cast<char*>(run), static_cast<std::streamsize>(n) * sizeof(Type));
+        if (input.gcount() != static_cast<std::streamsize>(n) * static_cast<std::streamsize>(sizeof(Type))) {
+            std::cerr << "Error: Failed to read " << options.externalInput << "." << std::endl;
+            exit(FILE_IO_ERROR);
+        }
+        NullInstrument ins;
+        parallelRadixSort(run, n, ins);
+        names[r] = runNum == 1 ? std::string(options.outputFile) : tempRunName(options.tempDir, stamp, nameIndex++);
+        counts[r] = n;
+        std::ofstream file;
+        openOutput(file, names[r]);
+        writeBlock(file, run, n);
+    }
+    input.close();
+    delete[] run;
+    std::chrono::steady_clock::time_point runEnd = std::chrono::steady_clock::now();
+
+    /* Merge passes */
+    int maxFanIn = static_cast<int>(std::min<long long>(INT_MAX, std::max(2LL, options.memoryLimit / EXTERNAL_MIN_BUFFER - 1)));
+    int passNum = 0;
+    while (runNum > 1) {
+        bool last = runNum <= maxFanIn;
+        int groupNum = (runNum + maxFanIn - 1) / maxFanIn;
+        for (int g = 0; g < groupNum; g++) {
+            int first = g * maxFanIn, k = std::min(maxFanIn, runNum - first);
+            std::string merged = last ? std::string(options.outputFile) : tempRunName(options.tempDir, stamp, nameIndex++);
+            long long mergedCount = 0;
+            for (int i = first; i < first + k; i++)
+                mergedCount += counts[i];
+            if (k == 1)
+                std::rename(names[first].c_str(), merged.c_str());
+            else {
+                mergeRunFiles<Type>(names + first, counts + first, k, merged, options.memoryLimit);
+                for (int i = first; i < first + k; i++)
+                    std::remove(names[i].c_str());
+            }
+            names[g] = merged;
+            counts[g] = mergedCount;
+        }
+        runNum = groupNum;
+        passNum++;
+    }
+    std::chrono::steady_clock::time_point mergeEnd = std::chrono::steady_clock::now();
+
+    double runTime = std::chrono::duration<double>(runEnd - begin).count();
+    double mergeTime = std::chrono::duration<double>(mergeEnd - runEnd).count();
+    std::cout << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+    std::cout << ">>> 外部排序: " << options.externalInput << " -> " << options.outputFile << std::endl;
+    std::cout << ">>> 元素数量: " << total << " (" << options.type << ")" << std::endl;
+    std::cout << ">>> 归并段数: " << std::max(1LL, (total + runCapacity - 1) / runCapacity) << " (每段最多 " << runCapacity << " 个元素)" << std::endl;
+    std::cout << ">>> 归并趟数: " << passNum << " (最大路数 " << maxFanIn << ")" << std::endl;
+    std::cout << ">>> 生成时间: " << runTime << "s" << std::endl;
+    std::cout << ">>> 归并时间: " << mergeTime << "s" << std::endl;
+    std::cout << ">>> 吞 吐 量: " << std::setprecision(0) << (runTime + mergeTime > 0 ? total / (runTime + mergeTime) : 0) << " 元素/秒" << std::endl;
+    delete[] counts;
+    delete[] names;
+}
+
+/*
+ * Function Name:    externalSort
+ * Function:         Run the external sort for the key type selected by --type
+ * Input Parameters: const BatchOptions& options
+ * Return Value:     void
+ */
+void externalSort(const BatchOptions& options)
+{
+    if (strcmp(options.type, "int64") == 0)
+        externalSort<long long>(options);
+    else if (strcmp(options.type, "int32") == 0)
+        externalSort<int>(options);
+    else {
+        std::cerr << "Error: The external sort supports the int32 and int64 key types only." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+}
+
+/*
+ * Function Name:    main
+ * Function:         Main function
+ * Input Parameters: int argc
+ *                   char* argv[]
+ * Return Value:     0
+ */
+int main(int argc, char* argv[])
+{
+    /* Batch mode */
+    if (argc > 1) {
+        BatchOptions options;
+        parseBatchOptions(argc, argv, options);
+        if (options.externalInput != NULL)
+            externalSort(options);
+        else
+            runBatch(options);
+        return 0;
+    }
+
+    /* Generate random number seed */
+    Xoshiro256 rng(static_cast<unsigned long long>(time(0)));
 
     /* System entry prompt */
     std::cout << "+------------------------------------+" << std::endl;
@@ -499,8 +6100,8 @@ int main()
     std::cout << "|  Comparison of Sorting Algorithms  |" << std::endl;
     std::cout << "+------------------------------------+" << std::endl << std::endl;
     std::cout << ">>> 排序算法:" << std::endl;
-    for (int i = 1; i <= 8; i++)
-        std::cout << "    [" << i << "] " << sortOptions[i - 1].description << std::endl;
+    for (int i = 1; i <= sortOptionNum; i++)
+        std::cout << "    [" << static_cast<char>(i <= 9 ? '0' + i : 'a' + i - 10) << "] " << sortOptions[i - 1].description << std::endl;
     std::cout << "    [0] 退出程序 Quit Program" << std::endl << std::endl;
 
     /* Generate random numbers */
@@ -510,16 +6111,40 @@ int main()
         std::cerr << "Error: Memory allocation failed." << std::endl;
         exit(MEMORY_ALLOCATION_ERROR);
     }
-    for (int i = 0; i < num; i++)
-        arr[i] = rand();
-    std::cout << std::endl << ">>> 随机数生成成功（随机数数量: " << num << "）" << std::endl;
+    std::cout << std::endl << ">>> 输入分布:" << std::endl;
+    for (int i = 1; i <= distributionOptionNum; i++)
+        std::cout << "    [" << i << "] " << distributionOptions[i - 1].description << std::endl;
+    std::cout << std::endl;
+    const DistributionOption& distOption = distributionOptions[inputInteger(1, distributionOptionNum, "输入分布序号") - 1];
+    distOption.func(arr, num, rng, defaultGeneratorParams);
+    std::cout << std::endl << ">>> 随机数生成成功（随机数数量: " << num << "，输入分布: " << distOption.description << "）" << std::endl << std::endl;
 
-    /* Sorting algorithm */
+    /* Benchmark configuration */
+    BenchmarkConfig config;
+    config.warmupReps = inputInteger(0, 100, "预热次数");
+    config.measuredReps = inputInteger(1, 1000, "测量次数");
+    config.useHardwareCounters = true;
+    config.collectStats = true;
+    config.verify = true;
+
+    /* Sorting algorithm, the latest result of each algorithm is kept for the counter table */
+    const char* names[sortOptionNum];
+    BenchmarkResult results[sortOptionNum];
+    int latest[sortOptionNum];
+    int count = 0;
+    for (int i = 0; i < sortOptionNum; i++)
+        latest[i] = -1;
     while (true) {
-        int optn = selectOptn();
-        if (optn == 0)
+        int optn = selectOptn(sortOptionNum);
+        if (optn == 0) {
+            if (count > 0)
+                printCounterTable(names, results, count, num);
             return 0;
-        else
-            performSort(sortOptions[optn - 1].func, arr, num, sortOptions[optn - 1].description);
+        }
+        if (latest[optn - 1] < 0) {
+            latest[optn - 1] = count++;
+            names[latest[optn - 1]] = sortOptions[optn - 1].name;
+        }
+        results[latest[optn - 1]] = performSort(sortOptions[optn - 1], arr, num, config);
     }
 }
\ No newline at end of file
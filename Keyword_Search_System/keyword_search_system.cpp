@@ -14,20 +14,48 @@
 #include <cstring>
 #include <iomanip>
 #include <climits>
+#include <chrono>
+#include <cerrno>
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_SEARCH_AVAILABLE
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 #ifdef _WIN32
 #include <conio.h>
 #include <Windows.h>
 #elif __linux__
 #include <ncurses.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #endif
 
 /* Macro definitions */
 #define MAX_LENGTH 64
+#define MAX_PATH_LENGTH 4096
+#define MAX_KEYWORD_LENGTH 4096
+#define ALPHABET_SIZE 256
+#define AUTO_SAMPLE_SIZE (1 << 16)
+#define AC_DENSE_MAX_ALPHABET 64
+#define AC_DENSE_MAX_CELLS (1 << 24)
+#define TEXT_BLOCK_SIZE (1 << 20)
+#define STREAM_CHUNK_SIZE (1 << 16)
 #define MEMORY_ALLOCATION_ERROR -1
 #define FILE_OPEN_ERROR -2
 #define FILE_EXIST_ERROR -3
 #define FILE_CREATE_ERROR -4
 #define INVALID_INDEX_ERROR -5
+#define INVALID_ARGUMENT_ERROR -6
+#define FILE_IO_ERROR -7
+#ifdef __GNUC__
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
 
 /*
  * Function Name:    hasSpace
@@ -72,12 +100,11 @@ void inputString(char* str, const char* strName)
 /*
  * Function Name:    selectOptn
  * Function:         Select operation
- * Input Parameters: void
+ * Input Parameters: int optnNum
  * Return Value:     operation
  */
-int selectOptn(void)
+int selectOptn(int optnNum)
 {
-    std::cout << std::endl << ">>> 字符串模式匹配算法: [1]BF(Brute-Force)算法 [2]KMP(Knuth-Morris-Pratt)算法" << std::endl;
     std::cout << std::endl << "请选择字符串模式匹配算法: ";
     char optn;
     while (true) {
@@ -101,60 +128,169 @@ int selectOptn(void)
             endwin();
 #endif
         }
-        else if (optn >= '1' && optn <= '2') {
+        else if (optn >= '1' && optn < '1' + optnNum) {
             std::cout << "[" << optn << "]" << std::endl << std::endl;
             return optn - '0';
         }
     }
 }
 
-/* Define KeywordSearch class */
-class KeywordSearch {
+/* Define TextFile class */
+class TextFile {
 private:
-    long long fileLen;
+    char* data;
+    long long size;
+    bool mapped;
+    void readBlocks(const char* filename);
+public:
+    TextFile() :data(NULL), size(0), mapped(false) {}
+    ~TextFile() { close(); }
+    void open(const char* filename);
+    void close(void);
+    const char* bytes(void) const { return data; }
+    long long length(void) const { return size; }
+};
+
+/*
+ * Function Name:    readBlocks
+ * Function:         Read the whole file into memory in large blocks
+ * Input Parameters: const char* filename
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   Used where the file cannot be mapped, the buffer doubles whenever it is full
+ */
+void TextFile::readBlocks(const char* filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: File " << filename << " open failed." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    long long capacity = TEXT_BLOCK_SIZE;
+    data = new(std::nothrow) char[static_cast<size_t>(capacity)];
+    if (data == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    while (file.read(data + size, static_cast<std::streamsize>(capacity - size)) || file.gcount() > 0) {
+        size += file.gcount();
+        if (size < capacity)
+            continue;
+        char* grown = new(std::nothrow) char[static_cast<size_t>(capacity * 2)];
+        if (grown == NULL) {
+            std::cerr << "Error: Memory allocation failed." << std::endl;
+            exit(MEMORY_ALLOCATION_ERROR);
+        }
+        memcpy(grown, data, static_cast<size_t>(size));
+        delete[] data;
+        data = grown;
+        capacity *= 2;
+    }
+    if (file.bad()) {
+        std::cerr << "Error: File " << filename << " read failed." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+}
+
+/*
+ * Function Name:    open
+ * Function:         Make the whole content of a file accessible as one contiguous buffer
+ * Input Parameters: const char* filename
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   Regular files are mapped read-only with a sequential read-ahead hint, other files are read in blocks
+ */
+void TextFile::open(const char* filename)
+{
+    close();
+#ifdef __linux__
+    int fd = ::open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Error: File " << filename << " open failed." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            data = static_cast<char*>(addr);
+            size = static_cast<long long>(st.st_size);
+            mapped = true;
+            madvise(data, static_cast<size_t>(size), MADV_SEQUENTIAL);
+            madvise(data, static_cast<size_t>(size), MADV_WILLNEED);
+        }
+    }
+    ::close(fd);
+    if (mapped || (S_ISREG(st.st_mode) && st.st_size == 0))
+        return;
+#endif
+    readBlocks(filename);
+}
+
+/*
+ * Function Name:    close
+ * Function:         Release the mapping or the buffer
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void TextFile::close(void)
+{
+#ifdef __linux__
+    if (mapped)
+        munmap(data, static_cast<size_t>(size));
+    else
+        delete[] data;
+#else
+    delete[] data;
+#endif
+    data = NULL;
+    size = 0;
+    mapped = false;
+}
+
+/* Define KMPMatcher class */
+class KMPMatcher {
+private:
+    const char* keyword;
     int keywordLen;
-    char filename[MAX_LENGTH + 1];
-    char keyword[MAX_LENGTH + 1];
-    char getCharFromFile(std::fstream& file, int index);
-    void getNext(int next[]);
+    int* next;
+    int k;
+    long long consumed;
+    void getNext(void);
 public:
-    KeywordSearch(const char* _filename) :fileLen(0), keywordLen(0), filename{ '\0' }, keyword{ '\0' } { strcpy(filename, _filename); }
-    void initializeFile(void);
-    void inputTextAndKeyword(std::fstream& file);
-    void outputText(std::fstream& file);
-    int BF_Search(std::fstream& file);
-    int KMP_Search(std::fstream& file);
-    void search(std::fstream& file, int optn);
+    KMPMatcher(const char* _keyword, int _keywordLen);
+    ~KMPMatcher() { delete[] next; }
+    long long feed(const char* chunk, long long chunkLen, std::ostream* positions);
+    long long position(void) const { return consumed; }
 };
 
 /*
- * Function Name:    getCharFromFile
- * Function:         Read a specified character from a file
- * Input Parameters: std::fstream& file
- *                   int index
- * Return Value:     a specified character
+ * Function Name:    KMPMatcher
+ * Function:         Create a matcher positioned at the beginning of the text
+ * Input Parameters: const char* _keyword
+ *                   int _keywordLen
  * Notes:            Class external implementation of member functions
+ *                   The keyword is not copied and must outlive the matcher
  */
-char KeywordSearch::getCharFromFile(std::fstream& file, int index)
+KMPMatcher::KMPMatcher(const char* _keyword, int _keywordLen) :keyword(_keyword), keywordLen(_keywordLen), next(NULL), k(-1), consumed(0)
 {
-    file.seekg(index, std::ios::beg);
-    char ch;
-    if (file.get(ch).good())
-        return ch;
-    else {
-        std::cerr << "Error: Index out of range." << std::endl;
-        exit(INVALID_INDEX_ERROR);
+    next = new(std::nothrow) int[keywordLen];
+    if (next == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
     }
+    getNext();
 }
 
 /*
  * Function Name:    getNext
  * Function:         Obtain the next[] array in the KMP algorithm
- * Input Parameters: int next[]
+ * Input Parameters: void
  * Return Value:     void
  * Notes:            Class external implementation of member functions
  */
-void KeywordSearch::getNext(int next[])
+void KMPMatcher::getNext(void)
 {
     int k = -1;
     next[0] = -1;
@@ -167,6 +303,699 @@ void KeywordSearch::getNext(int next[])
     }
 }
 
+/*
+ * Function Name:    feed
+ * Function:         Continue the KMP scan over the next chunk of the text
+ * Input Parameters: const char* chunk
+ *                   long long chunkLen
+ *                   std::ostream* positions
+ * Return Value:     the keyword count in this chunk
+ * Notes:            Class external implementation of member functions
+ *                   Only the matched prefix length k is carried between chunks, so matches crossing a chunk boundary
+ *                   are found without keeping old chunks. If positions is not NULL the text offset of every match is
+ *                   written to it
+ */
+long long KMPMatcher::feed(const char* chunk, long long chunkLen, std::ostream* positions)
+{
+    long long count = 0;
+    for (long long i = 0; i < chunkLen; i++) {
+        char ch = chunk[i];
+        while (k >= 0 && ch != keyword[k + 1])
+            k = next[k];
+        if (ch == keyword[k + 1])
+            k++;
+        if (k == keywordLen - 1) {
+            count++;
+            if (positions != NULL)
+                *positions << consumed + i - keywordLen + 1 << '\n';
+            k = next[k];
+        }
+    }
+    consumed += chunkLen;
+    return count;
+}
+
+/* Define AhoCorasick class */
+class AhoCorasick {
+private:
+    int keywordNum;
+    const char* const* keywords;
+    const int* keywordLens;
+    int* keywordIds;
+    int stateNum;
+    int* stateKeyword;
+    int* fail;
+    int* firstOutput;
+    int* outputLink;
+    int* edgeBegin;
+    unsigned char* edgeByte;
+    int* edgeTarget;
+    int rootNext[ALPHABET_SIZE];
+    bool dense;
+    int alphabetSize;
+    unsigned char byteClass[ALPHABET_SIZE];
+    int* denseNext;
+    long long* counts;
+    long long consumed;
+    int state;
+    int child(int s, unsigned char c) const;
+    void buildTrie(void);
+    void buildLinks(void);
+    void buildDenseTable(void);
+    template <bool Dense>
+    long long scan(const char* chunk, long long chunkLen, std::ostream* positions);
+public:
+    AhoCorasick(const char* const _keywords[], const int _keywordLens[], int _keywordNum);
+    ~AhoCorasick();
+    long long feed(const char* chunk, long long chunkLen, std::ostream* positions);
+    long long position(void) const { return consumed; }
+    long long keywordCount(int k) const { return counts[keywordIds[k]]; }
+    int states(void) const { return stateNum; }
+    bool denseTable(void) const { return dense; }
+};
+
+/*
+ * Function Name:    AhoCorasick
+ * Function:         Build the automaton of a keyword list
+ * Input Parameters: const char* const _keywords[]
+ *                   const int _keywordLens[]
+ *                   int _keywordNum
+ * Notes:            Class external implementation of member functions
+ *                   Keywords are not copied, need not be null-terminated and must not be empty. Equal keywords share
+ *                   one terminal state and one count. The dense table is used when the keywords contain at most
+ *                   AC_DENSE_MAX_ALPHABET distinct bytes and it fits in AC_DENSE_MAX_CELLS entries
+ */
+AhoCorasick::AhoCorasick(const char* const _keywords[], const int _keywordLens[], int _keywordNum) :keywordNum(_keywordNum), keywords(_keywords), keywordLens(_keywordLens), stateNum(1), dense(false), alphabetSize(0), denseNext(NULL), consumed(0), state(0)
+{
+    long long maxStates = 1;
+    for (int k = 0; k < keywordNum; k++)
+        maxStates += keywordLens[k];
+    if (maxStates > INT_MAX) {
+        std::cerr << "Error: Keyword list is too large." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    keywordIds = new(std::nothrow) int[keywordNum];
+    counts = new(std::nothrow) long long[keywordNum]();
+    stateKeyword = new(std::nothrow) int[maxStates];
+    fail = new(std::nothrow) int[maxStates];
+    firstOutput = new(std::nothrow) int[maxStates];
+    outputLink = new(std::nothrow) int[maxStates];
+    edgeBegin = new(std::nothrow) int[maxStates + 1];
+    edgeByte = new(std::nothrow) unsigned char[maxStates];
+    edgeTarget = new(std::nothrow) int[maxStates];
+    if (keywordIds == NULL || counts == NULL || stateKeyword == NULL || fail == NULL || firstOutput == NULL || outputLink == NULL || edgeBegin == NULL || edgeByte == NULL || edgeTarget == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    buildTrie();
+    buildLinks();
+    bool used[ALPHABET_SIZE] = { false };
+    int alphabet = 0;
+    for (int e = 0; e < stateNum - 1; e++)
+        used[edgeByte[e]] = true;
+    for (int c = 0; c < ALPHABET_SIZE; c++)
+        if (used[c])
+            alphabet++;
+    dense = alphabet <= AC_DENSE_MAX_ALPHABET && static_cast<long long>(stateNum) * (alphabet + 1) <= AC_DENSE_MAX_CELLS;
+    if (dense) {
+        for (int c = 0; c < ALPHABET_SIZE; c++)
+            byteClass[c] = used[c] ? static_cast<unsigned char>(++alphabetSize) : 0;
+        denseNext = new(std::nothrow) int[stateNum * (alphabetSize + 1)];
+        if (denseNext == NULL) {
+            std::cerr << "Error: Memory allocation failed." << std::endl;
+            exit(MEMORY_ALLOCATION_ERROR);
+        }
+        buildDenseTable();
+    }
+}
+
+/*
+ * Function Name:    ~AhoCorasick
+ * Function:         Release the automaton
+ * Notes:            Class external implementation of member functions
+ */
+AhoCorasick::~AhoCorasick()
+{
+    delete[] keywordIds;
+    delete[] counts;
+    delete[] stateKeyword;
+    delete[] fail;
+    delete[] firstOutput;
+    delete[] outputLink;
+    delete[] edgeBegin;
+    delete[] edgeByte;
+    delete[] edgeTarget;
+    delete[] denseNext;
+}
+
+/*
+ * Function Name:    child
+ * Function:         Find the goto transition of a state
+ * Input Parameters: int s
+ *                   unsigned char c
+ * Return Value:     the child state, or -1 if there is none
+ * Notes:            Class external implementation of member functions
+ *                   Binary search over the edges of s, which are sorted by byte
+ */
+int AhoCorasick::child(int s, unsigned char c) const
+{
+    int low = edgeBegin[s], high = edgeBegin[s + 1] - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (edgeByte[mid] == c)
+            return edgeTarget[mid];
+        else if (edgeByte[mid] < c)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+/*
+ * Function Name:    buildTrie
+ * Function:         Insert the keywords into a trie and store its edges compressed
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   The trie is first built with sorted sibling lists, then the edges of every state are laid out
+ *                   contiguously, sorted by byte, and the root edges are expanded into rootNext
+ */
+void AhoCorasick::buildTrie(void)
+{
+    int maxStates = 1;
+    for (int k = 0; k < keywordNum; k++)
+        maxStates += keywordLens[k];
+    int* firstChild = new(std::nothrow) int[maxStates];
+    int* nextSibling = new(std::nothrow) int[maxStates];
+    unsigned char* label = new(std::nothrow) unsigned char[maxStates];
+    if (firstChild == NULL || nextSibling == NULL || label == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    firstChild[0] = -1;
+    stateKeyword[0] = -1;
+    for (int k = 0; k < keywordNum; k++) {
+        int s = 0;
+        for (int i = 0; i < keywordLens[k]; i++) {
+            unsigned char c = static_cast<unsigned char>(keywords[k][i]);
+            int* link = &firstChild[s];
+            while (*link >= 0 && label[*link] < c)
+                link = &nextSibling[*link];
+            if (*link < 0 || label[*link] != c) {
+                label[stateNum] = c;
+                firstChild[stateNum] = -1;
+                nextSibling[stateNum] = *link;
+                stateKeyword[stateNum] = -1;
+                *link = stateNum++;
+            }
+            s = *link;
+        }
+        if (stateKeyword[s] < 0)
+            stateKeyword[s] = k;
+        keywordIds[k] = stateKeyword[s];
+    }
+    int edges = 0;
+    for (int s = 0; s < stateNum; s++) {
+        edgeBegin[s] = edges;
+        for (int t = firstChild[s]; t >= 0; t = nextSibling[t]) {
+            edgeByte[edges] = label[t];
+            edgeTarget[edges++] = t;
+        }
+    }
+    edgeBegin[stateNum] = edges;
+    for (int c = 0; c < ALPHABET_SIZE; c++)
+        rootNext[c] = 0;
+    for (int e = edgeBegin[0]; e < edgeBegin[1]; e++)
+        rootNext[edgeByte[e]] = edgeTarget[e];
+    delete[] firstChild;
+    delete[] nextSibling;
+    delete[] label;
+}
+
+/*
+ * Function Name:    buildLinks
+ * Function:         Compute the failure and output links in breadth-first order
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   firstOutput[s] is the first state on the failure chain of s (s included) that ends a keyword,
+ *                   outputLink[s] the next one after s, both -1 if there is none
+ */
+void AhoCorasick::buildLinks(void)
+{
+    int* queue = new(std::nothrow) int[stateNum];
+    if (queue == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    int head = 0, tail = 0;
+    fail[0] = 0;
+    firstOutput[0] = outputLink[0] = -1;
+    queue[tail++] = 0;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int e = edgeBegin[u]; e < edgeBegin[u + 1]; e++) {
+            int v = edgeTarget[e];
+            if (u == 0)
+                fail[v] = 0;
+            else {
+                int f = fail[u], next = -1;
+                while (f != 0 && (next = child(f, edgeByte[e])) < 0)
+                    f = fail[f];
+                fail[v] = f != 0 ? next : rootNext[edgeByte[e]];
+            }
+            outputLink[v] = firstOutput[fail[v]];
+            firstOutput[v] = stateKeyword[v] >= 0 ? v : outputLink[v];
+            queue[tail++] = v;
+        }
+    }
+    delete[] queue;
+}
+
+/*
+ * Function Name:    buildDenseTable
+ * Function:         Resolve every transition into a table indexed by state and byte class
+ * Input Parameters: void
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   Class 0 holds all bytes that occur in no keyword and always leads to the root. A row starts as a
+ *                   copy of the row of its failure state, which is shallower and therefore already complete, and
+ *                   the goto edges of the state are then written over it
+ */
+void AhoCorasick::buildDenseTable(void)
+{
+    const int width = alphabetSize + 1;
+    int* queue = new(std::nothrow) int[stateNum];
+    if (queue == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    int head = 0, tail = 0;
+    queue[tail++] = 0;
+    while (head < tail) {
+        int u = queue[head++];
+        int* row = denseNext + static_cast<long long>(u) * width;
+        if (u == 0)
+            for (int x = 0; x < width; x++)
+                row[x] = 0;
+        else
+            memcpy(row, denseNext + static_cast<long long>(fail[u]) * width, sizeof(int) * width);
+        for (int e = edgeBegin[u]; e < edgeBegin[u + 1]; e++) {
+            row[byteClass[edgeByte[e]]] = edgeTarget[e];
+            queue[tail++] = edgeTarget[e];
+        }
+    }
+    delete[] queue;
+}
+
+/*
+ * Function Name:    scan
+ * Function:         Run the automaton over a chunk with the dense or the compressed transitions
+ * Input Parameters: const char* chunk
+ *                   long long chunkLen
+ *                   std::ostream* positions
+ * Return Value:     the number of keyword occurrences in this chunk
+ * Notes:            Class external implementation of member functions
+ */
+template <bool Dense>
+long long AhoCorasick::scan(const char* chunk, long long chunkLen, std::ostream* positions)
+{
+    long long count = 0;
+    const int width = alphabetSize + 1;
+    int s = state;
+    for (long long i = 0; i < chunkLen; i++) {
+        unsigned char c = static_cast<unsigned char>(chunk[i]);
+        if (Dense)
+            s = denseNext[static_cast<long long>(s) * width + byteClass[c]];
+        else {
+            int next = -1;
+            while (s != 0 && (next = child(s, c)) < 0)
+                s = fail[s];
+            s = s != 0 ? next : rootNext[c];
+        }
+        for (int t = firstOutput[s]; t >= 0; t = outputLink[t]) {
+            int k = stateKeyword[t];
+            counts[k]++;
+            count++;
+            if (positions != NULL) {
+                *positions << consumed + i - keywordLens[k] + 1 << '\t';
+                positions->write(keywords[k], keywordLens[k]);
+                *positions << '\n';
+            }
+        }
+    }
+    state = s;
+    consumed += chunkLen;
+    return count;
+}
+
+/*
+ * Function Name:    feed
+ * Function:         Continue the scan over the next chunk of the text
+ * Input Parameters: const char* chunk
+ *                   long long chunkLen
+ *                   std::ostream* positions
+ * Return Value:     the number of keyword occurrences in this chunk
+ * Notes:            Class external implementation of member functions
+ *                   The automaton state is carried between chunks like the KMP state of KMPMatcher. If positions is
+ *                   not NULL every occurrence is written to it as its text offset and keyword
+ */
+long long AhoCorasick::feed(const char* chunk, long long chunkLen, std::ostream* positions)
+{
+    if (dense)
+        return scan<true>(chunk, chunkLen, positions);
+    else
+        return scan<false>(chunk, chunkLen, positions);
+}
+
+/*
+ * Function Name:    readStream
+ * Function:         Feed a file or standard input to a matcher in sequentially read chunks
+ * Input Parameters: const char* filename
+ *                   Matcher& matcher
+ *                   std::ostream* positions
+ * Return Value:     the total count returned by the matcher
+ * Notes:            The file name - reads standard input. A chunk is matched as soon as it arrives, and positions is
+ *                   flushed after every chunk
+ */
+template <typename Matcher>
+long long readStream(const char* filename, Matcher& matcher, std::ostream* positions)
+{
+    bool standardInput = strcmp(filename, "-") == 0;
+    long long count = 0;
+    char* chunk = new(std::nothrow) char[STREAM_CHUNK_SIZE];
+    if (chunk == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+#ifdef __linux__
+    int fd = standardInput ? STDIN_FILENO : ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: File " << filename << " open failed." << std::endl;
+        exit(FILE_OPEN_ERROR);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    while (true) {
+        ssize_t chunkLen = read(fd, chunk, STREAM_CHUNK_SIZE);
+        if (chunkLen < 0 && errno == EINTR)
+            continue;
+        if (chunkLen < 0) {
+            std::cerr << "Error: File " << filename << " read failed." << std::endl;
+            exit(FILE_IO_ERROR);
+        }
+        if (chunkLen == 0)
+            break;
+        count += matcher.feed(chunk, chunkLen, positions);
+        if (positions != NULL)
+            positions->flush();
+    }
+    if (!standardInput)
+        ::close(fd);
+#else
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (!standardInput) {
+        file.open(filename, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: File " << filename << " open failed." << std::endl;
+            exit(FILE_OPEN_ERROR);
+        }
+        in = &file;
+    }
+    while (in->read(chunk, STREAM_CHUNK_SIZE) || in->gcount() > 0) {
+        count += matcher.feed(chunk, in->gcount(), positions);
+        if (positions != NULL)
+            positions->flush();
+    }
+    if (in->bad()) {
+        std::cerr << "Error: File " << filename << " read failed." << std::endl;
+        exit(FILE_IO_ERROR);
+    }
+#endif
+    delete[] chunk;
+    return count;
+}
+
+/*
+ * Function Name:    firstLastSearchScalar
+ * Function:         Count the keyword with a first and last byte filter without SIMD
+ * Input Parameters: const char* text
+ *                   long long textLen
+ *                   const char* keyword
+ *                   int keywordLen
+ * Return Value:     the keyword count
+ * Notes:            memchr finds the next first byte, then the last byte and memcmp confirm the match
+ */
+long long firstLastSearchScalar(const char* text, long long textLen, const char* keyword, int keywordLen)
+{
+    long long count = 0;
+    const char* end = text + textLen - keywordLen + 1;
+    const char* p = text;
+    while (p < end) {
+        p = static_cast<const char*>(memchr(p, keyword[0], static_cast<size_t>(end - p)));
+        if (p == NULL)
+            break;
+        if (p[keywordLen - 1] == keyword[keywordLen - 1] && memcmp(p, keyword, keywordLen) == 0)
+            count++;
+        p++;
+    }
+    return count;
+}
+
+#ifdef SIMD_SEARCH_AVAILABLE
+/*
+ * Function Name:    cpuSupportsAvx2
+ * Function:         Check whether the CPU and the operating system support AVX2
+ * Input Parameters: void
+ * Return Value:     true / false
+ */
+bool cpuSupportsAvx2(void)
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+/*
+ * Function Name:    lowestSetBit
+ * Function:         Get the index of the lowest set bit
+ * Input Parameters: unsigned int mask
+ * Return Value:     the bit index
+ * Notes:            mask must not be 0
+ */
+inline int lowestSetBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/*
+ * Function Name:    firstLastSearchAvx2
+ * Function:         Count the keyword with a first and last byte filter over 32 positions per step
+ * Input Parameters: const char* text
+ *                   long long textLen
+ *                   const char* keyword
+ *                   int keywordLen
+ * Return Value:     the keyword count
+ * Notes:            Position i is a candidate when text[i] is the first and text[i + keywordLen - 1] the last keyword
+ *                   byte, only candidates are compared with memcmp. The tail shorter than a block is searched by
+ *                   firstLastSearchScalar
+ */
+AVX2_TARGET long long firstLastSearchAvx2(const char* text, long long textLen, const char* keyword, int keywordLen)
+{
+    long long count = 0, i = 0;
+    const __m256i first = _mm256_set1_epi8(keyword[0]);
+    const __m256i last = _mm256_set1_epi8(keyword[keywordLen - 1]);
+    for (; i + keywordLen - 1 + 32 <= textLen; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + keywordLen - 1));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+        while (mask != 0) {
+            if (memcmp(text + i + lowestSetBit(mask), keyword, keywordLen) == 0)
+                count++;
+            mask &= mask - 1;
+        }
+    }
+    return count + firstLastSearchScalar(text + i, textLen - i, keyword, keywordLen);
+}
+#endif
+
+/*
+ * Function Name:    horspoolShifts
+ * Function:         Build the bad character shift table of the Horspool algorithm
+ * Input Parameters: const char* keyword
+ *                   int keywordLen
+ *                   int shift[]
+ * Return Value:     void
+ * Notes:            shift[c] is the distance from the last occurrence of c in keyword[0..keywordLen - 2] to the end,
+ *                   or keywordLen if c does not occur there
+ */
+void horspoolShifts(const char* keyword, int keywordLen, int shift[])
+{
+    for (int c = 0; c < ALPHABET_SIZE; c++)
+        shift[c] = keywordLen;
+    for (int i = 0; i < keywordLen - 1; i++)
+        shift[static_cast<unsigned char>(keyword[i])] = keywordLen - 1 - i;
+}
+
+/*
+ * Function Name:    goodSuffixShifts
+ * Function:         Build the good suffix shift table of the Boyer-Moore algorithm
+ * Input Parameters: const char* keyword
+ *                   int keywordLen
+ *                   int shift[]
+ * Return Value:     void
+ * Notes:            shift[i] is the shift after a mismatch at keyword[i] with keyword[i + 1..] matched, shift[0] is
+ *                   also the shift after a full match
+ */
+void goodSuffixShifts(const char* keyword, int keywordLen, int shift[])
+{
+    int* suffix = new(std::nothrow) int[keywordLen];
+    if (suffix == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    int f = 0, g = keywordLen - 1;
+    suffix[keywordLen - 1] = keywordLen;
+    for (int i = keywordLen - 2; i >= 0; i--) {
+        if (i > g && suffix[i + keywordLen - 1 - f] < i - g)
+            suffix[i] = suffix[i + keywordLen - 1 - f];
+        else {
+            if (i < g)
+                g = i;
+            f = i;
+            while (g >= 0 && keyword[g] == keyword[g + keywordLen - 1 - f])
+                g--;
+            suffix[i] = f - g;
+        }
+    }
+    for (int i = 0; i < keywordLen; i++)
+        shift[i] = keywordLen;
+    for (int i = keywordLen - 1, j = 0; i >= 0; i--)
+        if (suffix[i] == i + 1)
+            for (; j < keywordLen - 1 - i; j++)
+                if (shift[j] == keywordLen)
+                    shift[j] = keywordLen - 1 - i;
+    for (int i = 0; i <= keywordLen - 2; i++)
+        shift[keywordLen - 1 - suffix[i]] = keywordLen - 1 - i;
+    delete[] suffix;
+}
+
+/*
+ * Function Name:    maximalSuffix
+ * Function:         Compute the maximal suffix of the keyword for the Two-Way algorithm
+ * Input Parameters: const char* keyword
+ *                   int keywordLen
+ *                   bool reversed
+ *                   int& period
+ * Return Value:     the position before the maximal suffix
+ * Notes:            Bytes are ordered as unsigned char, reversed selects the maximal suffix of the reversed order.
+ *                   period receives the period of that suffix
+ */
+int maximalSuffix(const char* keyword, int keywordLen, bool reversed, int& period)
+{
+    int ms = -1, j = 0, k = 1;
+    period = 1;
+    while (j + k < keywordLen) {
+        unsigned char a = static_cast<unsigned char>(keyword[j + k]), b = static_cast<unsigned char>(keyword[ms + k]);
+        if (a == b) {
+            if (k != period)
+                k++;
+            else {
+                j += period;
+                k = 1;
+            }
+        }
+        else if ((a < b) != reversed) {
+            j += k;
+            k = 1;
+            period = j - ms;
+        }
+        else {
+            ms = j;
+            j = ms + 1;
+            k = period = 1;
+        }
+    }
+    return ms;
+}
+
+/* Define KeywordSearch class */
+class KeywordSearch {
+private:
+    long long fileLen;
+    int keywordLen;
+    char filename[MAX_PATH_LENGTH + 1];
+    char keyword[MAX_KEYWORD_LENGTH + 1];
+public:
+    KeywordSearch(const char* _filename) :fileLen(0), keywordLen(0), filename{ '\0' }, keyword{ '\0' } { strcpy(filename, _filename); }
+    void initializeFile(void);
+    void setKeyword(const char* _keyword);
+    void inputTextAndKeyword(std::fstream& file);
+    void outputText(std::fstream& file);
+    long long BF_Search(const char* text, long long textLen);
+    long long KMP_Search(const char* text, long long textLen);
+    long long SIMD_Search(const char* text, long long textLen);
+    long long BM_Search(const char* text, long long textLen);
+    long long Horspool_Search(const char* text, long long textLen);
+    long long Sunday_Search(const char* text, long long textLen);
+    long long TwoWay_Search(const char* text, long long textLen);
+    long long Auto_Search(const char* text, long long textLen);
+    int selectSearchOption(const char* text, long long textLen);
+    void search(int optn);
+    void streamSearch(bool positions);
+};
+
+/* Define SearchOption structure */
+typedef long long (KeywordSearch::* SearchFunction)(const char* text, long long textLen);
+struct SearchOption {
+    SearchFunction func;
+    const char* name;
+    const char* description;
+};
+
+/* Define search options */
+const SearchOption searchOptions[] = {
+    { &KeywordSearch::BF_Search, "bf", "BF(Brute-Force)算法" },
+    { &KeywordSearch::KMP_Search, "kmp", "KMP(Knuth-Morris-Pratt)算法" },
+    { &KeywordSearch::SIMD_Search, "simd", "SIMD首尾字节过滤算法" },
+    { &KeywordSearch::BM_Search, "bm", "BM(Boyer-Moore)算法" },
+    { &KeywordSearch::Horspool_Search, "horspool", "Horspool算法" },
+    { &KeywordSearch::Sunday_Search, "sunday", "Sunday算法" },
+    { &KeywordSearch::TwoWay_Search, "two-way", "Two-Way(Crochemore-Perrin)算法" },
+    { &KeywordSearch::Auto_Search, "auto", "自动选择算法" }
+};
+const int searchOptionNum = sizeof(searchOptions) / sizeof(searchOptions[0]);
+
+/*
+ * Function Name:    setKeyword
+ * Function:         Set the keyword
+ * Input Parameters: const char* _keyword
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ */
+void KeywordSearch::setKeyword(const char* _keyword)
+{
+    strcpy(keyword, _keyword);
+    keywordLen = static_cast<int>(strlen(keyword));
+}
+
 /*
  * Function Name:    inputTextAndKeyword
  * Function:         Input text and keyword
@@ -210,17 +1039,18 @@ void KeywordSearch::outputText(std::fstream& file)
 /*
  * Function Name:    BF_Search
  * Function:         BF (Brute-Force) algorithm
- * Input Parameters: std::fstream& file
+ * Input Parameters: const char* text
+ *                   long long textLen
  * Return Value:     the keyword count
  * Notes:            Class external implementation of member functions
  */
-int KeywordSearch::BF_Search(std::fstream& file)
+long long KeywordSearch::BF_Search(const char* text, long long textLen)
 {
-    int count = 0;
-    for (int i = 0; i < fileLen - keywordLen + 1; i++) {
+    long long count = 0;
+    for (long long i = 0; i + keywordLen <= textLen; i++) {
         int j = 0;
         for (; j < keywordLen; j++)
-            if (getCharFromFile(file, i + j) != keyword[j])
+            if (text[i + j] != keyword[j])
                 break;
         if (j == keywordLen)
             count++;
@@ -231,67 +1061,497 @@ int KeywordSearch::BF_Search(std::fstream& file)
 /*
  * Function Name:    KMP_Search
  * Function:         KMP (Knuth-Morris-Pratt) algorithm
- * Input Parameters: std::fstream& file
+ * Input Parameters: const char* text
+ *                   long long textLen
  * Return Value:     the keyword count
  * Notes:            Class external implementation of member functions
  */
-int KeywordSearch::KMP_Search(std::fstream& file)
+long long KeywordSearch::KMP_Search(const char* text, long long textLen)
 {
-    int count = 0, k = -1;
-    int* next = new(std::nothrow) int[keywordLen];
-    if (next == NULL) {
+    KMPMatcher matcher(keyword, keywordLen);
+    return matcher.feed(text, textLen, NULL);
+}
+
+/*
+ * Function Name:    SIMD_Search
+ * Function:         SIMD first and last byte filter algorithm
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ *                   Uses AVX2 when the CPU supports it and the scalar filter otherwise
+ */
+long long KeywordSearch::SIMD_Search(const char* text, long long textLen)
+{
+    if (keywordLen > textLen)
+        return 0;
+#ifdef SIMD_SEARCH_AVAILABLE
+    static const bool avx2 = cpuSupportsAvx2();
+    if (avx2)
+        return firstLastSearchAvx2(text, textLen, keyword, keywordLen);
+#endif
+    return firstLastSearchScalar(text, textLen, keyword, keywordLen);
+}
+
+/*
+ * Function Name:    BM_Search
+ * Function:         BM (Boyer-Moore) algorithm
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ *                   Compares from the right and shifts by the larger of the bad character and good suffix rules
+ */
+long long KeywordSearch::BM_Search(const char* text, long long textLen)
+{
+    long long count = 0;
+    int badChar[ALPHABET_SIZE];
+    int* goodSuffix = new(std::nothrow) int[keywordLen];
+    if (goodSuffix == NULL) {
         std::cerr << "Error: Memory allocation failed." << std::endl;
         exit(MEMORY_ALLOCATION_ERROR);
     }
-    getNext(next);
-    for (int i = 0; i < fileLen; i++) {
-        while (k >= 0 && getCharFromFile(file, i) != keyword[k + 1])
-            k = next[k];
-        if (getCharFromFile(file, i) == keyword[k + 1])
-            k++;
-        if (k == keywordLen - 1) {
+    horspoolShifts(keyword, keywordLen, badChar);
+    goodSuffixShifts(keyword, keywordLen, goodSuffix);
+    for (long long pos = 0; pos + keywordLen <= textLen;) {
+        int i = keywordLen - 1;
+        while (i >= 0 && keyword[i] == text[pos + i])
+            i--;
+        if (i < 0) {
             count++;
-            k = next[k];
+            pos += goodSuffix[0];
+        }
+        else {
+            int bad = badChar[static_cast<unsigned char>(text[pos + i])] - keywordLen + 1 + i;
+            pos += goodSuffix[i] > bad ? goodSuffix[i] : bad;
+        }
+    }
+    delete[] goodSuffix;
+    return count;
+}
+
+/*
+ * Function Name:    Horspool_Search
+ * Function:         Horspool algorithm
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ *                   The shift depends only on the text byte under the last keyword byte
+ */
+long long KeywordSearch::Horspool_Search(const char* text, long long textLen)
+{
+    long long count = 0;
+    int shift[ALPHABET_SIZE];
+    horspoolShifts(keyword, keywordLen, shift);
+    const char last = keyword[keywordLen - 1];
+    for (long long pos = 0; pos + keywordLen <= textLen; pos += shift[static_cast<unsigned char>(text[pos + keywordLen - 1])])
+        if (text[pos + keywordLen - 1] == last && memcmp(text + pos, keyword, keywordLen - 1) == 0)
+            count++;
+    return count;
+}
+
+/*
+ * Function Name:    Sunday_Search
+ * Function:         Sunday (Quick Search) algorithm
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ *                   The shift depends on the text byte just after the window, so it can be keywordLen + 1
+ */
+long long KeywordSearch::Sunday_Search(const char* text, long long textLen)
+{
+    long long count = 0;
+    int shift[ALPHABET_SIZE];
+    for (int c = 0; c < ALPHABET_SIZE; c++)
+        shift[c] = keywordLen + 1;
+    for (int i = 0; i < keywordLen; i++)
+        shift[static_cast<unsigned char>(keyword[i])] = keywordLen - i;
+    for (long long pos = 0; pos + keywordLen <= textLen; pos += shift[static_cast<unsigned char>(text[pos + keywordLen])]) {
+        if (memcmp(text + pos, keyword, keywordLen) == 0)
+            count++;
+        if (pos + keywordLen == textLen)
+            break;
+    }
+    return count;
+}
+
+/*
+ * Function Name:    TwoWay_Search
+ * Function:         Two-Way (Crochemore-Perrin) algorithm
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ *                   The keyword is split at its critical factorization, the right part is matched left to right and
+ *                   the left part right to left. Linear time with constant extra space, the memory of the matched
+ *                   prefix is used when the keyword is periodic
+ */
+long long KeywordSearch::TwoWay_Search(const char* text, long long textLen)
+{
+    long long count = 0;
+    int period, reversedPeriod;
+    int split = maximalSuffix(keyword, keywordLen, false, period);
+    int reversedSplit = maximalSuffix(keyword, keywordLen, true, reversedPeriod);
+    if (reversedSplit > split) {
+        split = reversedSplit;
+        period = reversedPeriod;
+    }
+    if (memcmp(keyword, keyword + period, split + 1) == 0) {
+        int memory = -1;
+        for (long long pos = 0; pos + keywordLen <= textLen;) {
+            int i = (split > memory ? split : memory) + 1;
+            while (i < keywordLen && keyword[i] == text[pos + i])
+                i++;
+            if (i < keywordLen) {
+                pos += i - split;
+                memory = -1;
+                continue;
+            }
+            i = split;
+            while (i > memory && keyword[i] == text[pos + i])
+                i--;
+            if (i <= memory)
+                count++;
+            pos += period;
+            memory = keywordLen - period - 1;
+        }
+    }
+    else {
+        period = (split + 1 > keywordLen - split - 1 ? split + 1 : keywordLen - split - 1) + 1;
+        for (long long pos = 0; pos + keywordLen <= textLen;) {
+            int i = split + 1;
+            while (i < keywordLen && keyword[i] == text[pos + i])
+                i++;
+            if (i < keywordLen) {
+                pos += i - split;
+                continue;
+            }
+            i = split;
+            while (i >= 0 && keyword[i] == text[pos + i])
+                i--;
+            if (i < 0)
+                count++;
+            pos += period;
         }
     }
-    delete[] next;
     return count;
 }
 
+/*
+ * Function Name:    selectSearchOption
+ * Function:         Choose a search algorithm from the keyword length and the alphabet of the text
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the index of the chosen option in searchOptions
+ * Notes:            Class external implementation of member functions
+ *                   The alphabet is estimated from the distinct bytes of the first AUTO_SAMPLE_SIZE text bytes.
+ *                   With AVX2 the first and last byte filter is fastest for any keyword length, except over binary
+ *                   alphabets where nearly every position is a candidate and the linear Two-Way is used. The scalar
+ *                   filter only wins for short keywords over a large alphabet, otherwise the skips of Sunday and, for
+ *                   very long keywords, Boyer-Moore are faster
+ */
+int KeywordSearch::selectSearchOption(const char* text, long long textLen)
+{
+    bool seen[ALPHABET_SIZE] = { false };
+    int alphabet = 0;
+    for (long long i = 0; i < textLen && i < AUTO_SAMPLE_SIZE; i++)
+        if (!seen[static_cast<unsigned char>(text[i])]) {
+            seen[static_cast<unsigned char>(text[i])] = true;
+            alphabet++;
+        }
+    bool avx2 = false;
+#ifdef SIMD_SEARCH_AVAILABLE
+    avx2 = cpuSupportsAvx2();
+#endif
+    const char* name = "sunday";
+    if (alphabet <= 2)
+        name = "two-way";
+    else if (avx2 || (alphabet > 4 && keywordLen <= 8))
+        name = "simd";
+    else if (keywordLen >= 256)
+        name = "bm";
+    for (int i = 0; i < searchOptionNum; i++)
+        if (strcmp(searchOptions[i].name, name) == 0)
+            return i;
+    return 0;
+}
+
+/*
+ * Function Name:    Auto_Search
+ * Function:         Search with the algorithm chosen by selectSearchOption
+ * Input Parameters: const char* text
+ *                   long long textLen
+ * Return Value:     the keyword count
+ * Notes:            Class external implementation of member functions
+ */
+long long KeywordSearch::Auto_Search(const char* text, long long textLen)
+{
+    return (this->*searchOptions[selectSearchOption(text, textLen)].func)(text, textLen);
+}
+
 /*
  * Function Name:    search
  * Function:         Keyword Search
- * Input Parameters: std::fstream& file
- *                   int optn
+ * Input Parameters: int optn
  * Return Value:     void
  * Notes:            Class external implementation of member functions
+ *                   The file is opened as one contiguous buffer, so the algorithms scan memory instead of seeking
  */
-void KeywordSearch::search(std::fstream& file, int optn)
+void KeywordSearch::search(int optn)
 {
-    int count = 0;
-#ifdef _WIN32
-    LARGE_INTEGER tick, begin, end;
-    QueryPerformanceFrequency(&tick);
-    QueryPerformanceCounter(&begin);
-#endif
-    if (optn == 1)
-        count = BF_Search(file);
-    else if (optn == 2)
-        count = KMP_Search(file);
-#ifdef _WIN32
-    QueryPerformanceCounter(&end);
-    std::cout << ">> 检索结束（检索时长: " << std::setiosflags(std::ios::fixed) << std::setprecision(6) << double(end.QuadPart - begin.QuadPart) / tick.QuadPart << "秒" << "）" << std::endl << std::endl;
-#endif
+    long long count = 0;
+    TextFile text;
+    text.open(filename);
+    fileLen = text.length();
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (optn >= 1 && optn <= searchOptionNum && searchOptions[optn - 1].func == &KeywordSearch::Auto_Search) {
+        optn = selectSearchOption(text.bytes(), text.length()) + 1;
+        std::cout << ">> 自动选择: " << searchOptions[optn - 1].description << std::endl << std::endl;
+    }
+    if (optn >= 1 && optn <= searchOptionNum)
+        count = (this->*searchOptions[optn - 1].func)(text.bytes(), text.length());
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << ">> 检索结束（检索时长: " << std::setiosflags(std::ios::fixed) << std::setprecision(6) << std::chrono::duration<double>(end - begin).count() << "秒" << "）" << std::endl << std::endl;
     std::cout << "关键词 \"" << keyword << "\" 在文本文件 " << filename << " 中出现 " << count << " 次" << std::endl << std::endl;
 }
 
+/*
+ * Function Name:    streamSearch
+ * Function:         Keyword Search over sequentially read chunks
+ * Input Parameters: bool positions
+ * Return Value:     void
+ * Notes:            Class external implementation of member functions
+ *                   The file name - reads standard input. Only one chunk and the KMP state are kept, so pipes, live
+ *                   streams and files larger than memory are searched in O(keyword) extra memory
+ */
+void KeywordSearch::streamSearch(bool positions)
+{
+    bool standardInput = strcmp(filename, "-") == 0;
+    KMPMatcher matcher(keyword, keywordLen);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    long long count = readStream(filename, matcher, positions ? &std::cout : NULL);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    fileLen = matcher.position();
+    std::cout << ">> 检索结束（检索时长: " << std::setiosflags(std::ios::fixed) << std::setprecision(6) << std::chrono::duration<double>(end - begin).count() << "秒，文本长度: " << fileLen << "）" << std::endl << std::endl;
+    if (standardInput)
+        std::cout << "关键词 \"" << keyword << "\" 在标准输入中出现 " << count << " 次" << std::endl << std::endl;
+    else
+        std::cout << "关键词 \"" << keyword << "\" 在文本文件 " << filename << " 中出现 " << count << " 次" << std::endl << std::endl;
+}
+
+/*
+ * Function Name:    multiSearch
+ * Function:         Search all keywords of a keyword file in one pass with an Aho-Corasick automaton
+ * Input Parameters: const char* filename
+ *                   const char* keywordFilename
+ *                   bool stream
+ *                   bool positions
+ * Return Value:     void
+ * Notes:            The keyword file holds one keyword per line, empty lines are skipped. The text is mapped, or read
+ *                   in chunks with stream, and the count of every keyword is reported
+ */
+void multiSearch(const char* filename, const char* keywordFilename, bool stream, bool positions)
+{
+    TextFile keywordFile;
+    keywordFile.open(keywordFilename);
+    const char* bytes = keywordFile.bytes();
+    long long length = keywordFile.length();
+    int keywordNum = 0;
+    for (long long i = 0; i < length; i++)
+        if (bytes[i] == '\n' || i == length - 1)
+            keywordNum++;
+    const char** keywords = new(std::nothrow) const char*[keywordNum + 1];
+    int* keywordLens = new(std::nothrow) int[keywordNum + 1];
+    if (keywords == NULL || keywordLens == NULL) {
+        std::cerr << "Error: Memory allocation failed." << std::endl;
+        exit(MEMORY_ALLOCATION_ERROR);
+    }
+    keywordNum = 0;
+    for (long long begin = 0, end = 0; begin < length; begin = end + 1) {
+        end = begin;
+        while (end < length && bytes[end] != '\n')
+            end++;
+        long long keywordLen = end - begin;
+        if (keywordLen > 0 && bytes[end - 1] == '\r')
+            keywordLen--;
+        if (keywordLen == 0)
+            continue;
+        if (keywordLen > MAX_KEYWORD_LENGTH) {
+            std::cerr << "Error: Keyword on byte " << begin << " of " << keywordFilename << " is longer than " << MAX_KEYWORD_LENGTH << " bytes." << std::endl;
+            exit(INVALID_ARGUMENT_ERROR);
+        }
+        keywords[keywordNum] = bytes + begin;
+        keywordLens[keywordNum++] = static_cast<int>(keywordLen);
+    }
+    if (keywordNum == 0) {
+        std::cerr << "Error: Keyword file " << keywordFilename << " contains no keywords." << std::endl;
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    AhoCorasick automaton(keywords, keywordLens, keywordNum);
+    std::chrono::steady_clock::time_point built = std::chrono::steady_clock::now();
+    std::cout << ">> 自动机构建完成（构建时长: " << std::setiosflags(std::ios::fixed) << std::setprecision(6) << std::chrono::duration<double>(built - begin).count() << "秒，关键词数: " << keywordNum << "，状态数: " << automaton.states() << "，转移表: " << (automaton.denseTable() ? "稠密 dense" : "压缩 compressed") << "）" << std::endl << std::endl;
+    long long count;
+    if (stream)
+        count = readStream(filename, automaton, positions ? &std::cout : NULL);
+    else {
+        TextFile text;
+        text.open(filename);
+        count = automaton.feed(text.bytes(), text.length(), positions ? &std::cout : NULL);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << ">> 检索结束（检索时长: " << std::chrono::duration<double>(end - built).count() << "秒，文本长度: " << automaton.position() << "）" << std::endl << std::endl;
+    for (int k = 0; k < keywordNum; k++) {
+        std::cout << "关键词 \"";
+        std::cout.write(keywords[k], keywordLens[k]);
+        std::cout << "\" 出现 " << automaton.keywordCount(k) << " 次" << std::endl;
+    }
+    std::cout << std::endl << "共匹配 " << count << " 次" << std::endl << std::endl;
+    delete[] keywords;
+    delete[] keywordLens;
+}
+
+/*
+ * Function Name:    printUsage
+ * Function:         Print the command line usage
+ * Input Parameters: const char* program
+ * Return Value:     void
+ */
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " --file FILE --keyword KEYWORD [options]" << std::endl;
+    std::cout << "       " << program << " --file FILE --keywords KEYWORD_FILE [--stream] [--positions]" << std::endl;
+    std::cout << "  Without options the interactive mode is started." << std::endl << std::endl;
+    std::cout << "  --file FILE           text file to search, mapped into memory, - reads standard input as a stream" << std::endl;
+    std::cout << "  --keyword KEYWORD     keyword of at most " << MAX_KEYWORD_LENGTH << " bytes" << std::endl;
+    std::cout << "  --keywords FILE       one keyword per line, all searched in one pass with an Aho-Corasick automaton" << std::endl;
+    std::cout << "  --algo NAME           string matching algorithm (default: kmp):";
+    for (int i = 0; i < searchOptionNum; i++)
+        std::cout << " " << searchOptions[i].name;
+    std::cout << std::endl;
+    std::cout << "  --stream              read FILE sequentially in " << STREAM_CHUNK_SIZE / 1024 << " KiB chunks with the streaming KMP matcher" << std::endl;
+    std::cout << "                        or the automaton of --keywords" << std::endl;
+    std::cout << "  --positions           print the offset of every match as soon as it is found, with --stream or --keywords" << std::endl;
+}
+
+/*
+ * Function Name:    argumentError
+ * Function:         Report an invalid command line argument and exit
+ * Input Parameters: const char* option
+ *                   const char* value
+ * Return Value:     void
+ */
+void argumentError(const char* option, const char* value)
+{
+    std::cerr << "Error: Invalid value \"" << (value == NULL ? "" : value) << "\" for option " << option << "." << std::endl;
+    exit(INVALID_ARGUMENT_ERROR);
+}
+
+/*
+ * Function Name:    optionValue
+ * Function:         Get the value following a command line option
+ * Input Parameters: int argc
+ *                   char* argv[]
+ *                   int& i
+ * Return Value:     the option value
+ */
+const char* optionValue(int argc, char* argv[], int& i)
+{
+    if (i + 1 >= argc)
+        argumentError(argv[i], NULL);
+    return argv[++i];
+}
+
+/*
+ * Function Name:    runBatch
+ * Function:         Search a keyword in an existing file from the command line
+ * Input Parameters: int argc
+ *                   char* argv[]
+ * Return Value:     void
+ */
+void runBatch(int argc, char* argv[])
+{
+    const char* filename = NULL;
+    const char* keyword = NULL;
+    const char* keywordFile = NULL;
+    int optn = 2;
+    bool stream = false, positions = false;
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (strcmp(option, "--help") == 0 || strcmp(option, "-h") == 0) {
+            printUsage(argv[0]);
+            exit(0);
+        }
+        else if (strcmp(option, "--file") == 0) {
+            filename = optionValue(argc, argv, i);
+            if (strlen(filename) > MAX_PATH_LENGTH)
+                argumentError(option, filename);
+        }
+        else if (strcmp(option, "--keyword") == 0) {
+            keyword = optionValue(argc, argv, i);
+            if (*keyword == '\0' || strlen(keyword) > MAX_KEYWORD_LENGTH)
+                argumentError(option, keyword);
+        }
+        else if (strcmp(option, "--keywords") == 0)
+            keywordFile = optionValue(argc, argv, i);
+        else if (strcmp(option, "--stream") == 0)
+            stream = true;
+        else if (strcmp(option, "--positions") == 0)
+            positions = true;
+        else if (strcmp(option, "--algo") == 0) {
+            const char* value = optionValue(argc, argv, i);
+            optn = 0;
+            for (int j = 0; j < searchOptionNum; j++)
+                if (strcmp(value, searchOptions[j].name) == 0)
+                    optn = j + 1;
+            if (optn == 0)
+                argumentError(option, value);
+        }
+        else {
+            std::cerr << "Error: Unknown option " << option << "." << std::endl;
+            printUsage(argv[0]);
+            exit(INVALID_ARGUMENT_ERROR);
+        }
+    }
+    if (filename == NULL || (keyword == NULL) == (keywordFile == NULL)) {
+        printUsage(argv[0]);
+        exit(INVALID_ARGUMENT_ERROR);
+    }
+    if (strcmp(filename, "-") == 0)
+        stream = true;
+    if (keywordFile != NULL) {
+        multiSearch(filename, keywordFile, stream, positions);
+        return;
+    }
+    if (stream && optn != 2)
+        argumentError("--algo", searchOptions[optn - 1].name);
+    if (positions && !stream)
+        argumentError("--positions", "");
+    KeywordSearch keywordSearch(filename);
+    keywordSearch.setKeyword(keyword);
+    if (stream)
+        keywordSearch.streamSearch(positions);
+    else
+        keywordSearch.search(optn);
+}
+
 /*
  * Function Name:    main
  * Function:         Main function
+ * Input Parameters: int argc
+ *                   char* argv[]
  * Return Value:     0
  */
-int main()
+int main(int argc, char* argv[])
 {
+    /* Batch mode */
+    if (argc > 1) {
+        runBatch(argc, argv);
+        return 0;
+    }
+
     /* System entry prompt */
     std::cout << "+-------------------------+" << std::endl;
     std::cout << "|     关键词检索系统      |" << std::endl;
@@ -325,8 +1585,12 @@ int main()
     KeywordSearch keywordSearch(filename);
     keywordSearch.inputTextAndKeyword(textFile);
     keywordSearch.outputText(textFile);
-    keywordSearch.search(textFile, selectOptn());
     textFile.close();
+    std::cout << std::endl << ">>> 字符串模式匹配算法:";
+    for (int i = 0; i < searchOptionNum; i++)
+        std::cout << " [" << i + 1 << "]" << searchOptions[i].description;
+    std::cout << std::endl;
+    keywordSearch.search(selectOptn(searchOptionNum));
 
     /* Wait for enter to quit */
     std::cout << "Press Enter to Quit" << std::endl;